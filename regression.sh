@@ -0,0 +1,112 @@
+#!/usr/bin/env bash
+#
+# Runs a subset of datasets/ under fixed seeds and time budgets and compares
+# the best and mean objective, and the time needed to reach the reference best
+# value, with a results summary such as the ones produced by analyze_results.sh.
+#
+# Usage: ./regression.sh [--binary PATH] [--reference FILE] [--runs N] [--seed S]
+#                        [--datasets "name:k:time ..."] [--time-scale F]
+#                        [--tolerance T] [--slowdown F] [--options "name=value ..."]
+#                        [--report FILE]
+#
+# A dataset is a REGRESSION when its best or mean objective is worse than the
+# reference by more than the relative tolerance, and SLOWER when its runs
+# take more than slowdown times the reference mean time to reach the reference
+# best value, and FAILED when the binary exits with an error or reports
+# fewer than the requested runs. The per-dataset report is written as CSV;
+# the exit status is 1 if any dataset regressed or failed.
+
+binary="./src/lima_vns_64"
+reference="Original Algorithm Final Results Summary -.csv"
+runs=3
+seed=1
+datasets="iris:3:0.42 wine:3:0.60 glass:7:2.54 thyroid:3:1.45 ionosphere:2:3.65 body:2:10.51"
+time_scale=1
+tolerance=0.001
+slowdown=2
+options=""
+report="regression_report.csv"
+
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    --binary) binary="$2"; shift 2 ;;
+    --reference) reference="$2"; shift 2 ;;
+    --runs) runs="$2"; shift 2 ;;
+    --seed) seed="$2"; shift 2 ;;
+    --datasets) datasets="$2"; shift 2 ;;
+    --time-scale) time_scale="$2"; shift 2 ;;
+    --tolerance) tolerance="$2"; shift 2 ;;
+    --slowdown) slowdown="$2"; shift 2 ;;
+    --options) options="$2"; shift 2 ;;
+    --report) report="$2"; shift 2 ;;
+    *) echo "Unknown argument: $1"; exit 2 ;;
+  esac
+done
+
+[[ -x "$binary" ]] || { echo "Executable not found: $binary"; exit 2; }
+[[ -f "$reference" ]] || { echo "Reference summary not found: $reference"; exit 2; }
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+printf "Dataset,Clusters,TimeLimit,Runs,Best,Mean,RefBest,RefMean,BestGap,MeanGap,RunsReachingRef,MeanTimeToRef,RefMeanTime,Status\n" > "$report"
+
+failed=0
+for entry in $datasets; do
+  IFS=':' read -r name clusters limit <<< "$entry"
+  limit=$(awk -v t="$limit" -v s="$time_scale" 'BEGIN{ printf "%.2f", t*s }')
+
+  ref=$(awk -F',' -v ds="$name" '$1==ds { print $2","$4","$8 }' "$reference")
+  if [[ -z "$ref" ]]; then
+    echo "$name: no reference in $reference, skipped"
+    continue
+  fi
+
+  echo "Running $name (k=$clusters, ${limit}s, $runs runs from seed $seed)"
+  # shellcheck disable=SC2086
+  "$binary" "datasets/$name.csv" "$clusters" "$limit" "$runs" "$seed" \
+      "$work/$name-stats" "$work/$name-assignment" $options > "$work/$name.log"
+  exit_status=$?
+
+  # Each run prints its initial value and every improvement with the time it
+  # was found, then its final value.
+  line=$(awk -v ref="$ref" -v name="$name" -v k="$clusters" -v limit="$limit" \
+              -v tol="$tolerance" -v slow="$slowdown" -v runs="$runs" -v exitStatus="$exit_status" '
+    BEGIN{ split(ref, r, ","); refBest=r[1]+0; refMean=r[2]+0; refTime=r[3]+0;
+           target=refBest*(1+tol); run=0; results=0 }
+    /Execution [0-9]+/ { run++; reached[run]=-1 }
+    /Initial Solution Value:|Found new best solution/ {
+      value=$0; sub(/.*(Value: |solution = )/, "", value); split(value, f, " "); value=f[1]+0
+      t=$0; sub(/.* at /, "", t); sub(/s$/, "", t); t+=0
+      if (reached[run] < 0 && value <= target) reached[run]=t
+    }
+    /^Objective Function value:/ {
+      value=$4+0; final[run]=value; results++
+      if (results==1 || value<best) best=value
+      sum+=value
+    }
+    END{
+      # A crash, a timeout or a missing run would leave a partial mean
+      if (exitStatus != 0 || results < runs) {
+        printf "%s,%s,%s,%d,,,%.10e,%.10e,,,,,%.4f,FAILED\n", name, k, limit, results, refBest, refMean, refTime; exit
+      }
+      mean=sum/results
+      nReached=0; ttr=0
+      for (i=1; i<=run; i++) if (reached[i] >= 0) { nReached++; ttr+=reached[i] }
+      ttrText = nReached > 0 ? sprintf("%.4f", ttr/nReached) : ""
+      bestGap=(best-refBest)/refBest; meanGap=(mean-refMean)/refMean
+      status="PASS"
+      if (nReached > 0 && ttr/nReached > slow*refTime) status="SLOWER"
+      if (bestGap > tol || meanGap > tol) status="REGRESSION"
+      printf "%s,%s,%s,%d,%.10e,%.10e,%.10e,%.10e,%.6f,%.6f,%d,%s,%.4f,%s\n",
+             name, k, limit, run, best, mean, refBest, refMean, bestGap, meanGap, nReached, ttrText, refTime, status
+    }' "$work/$name.log")
+
+  echo "$line" >> "$report"
+  status="${line##*,}"
+  echo "  $status: $line"
+  [[ "$status" == "REGRESSION" || "$status" == "FAILED" ]] && failed=1
+done
+
+echo "Report written to $report"
+exit $failed
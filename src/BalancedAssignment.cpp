@@ -0,0 +1,138 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "BalancedAssignment.h"
+#include <float.h>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+// Cycles must save more than this fraction of the total cost to be applied.
+static const double CYCLE_TOLERANCE = 1e-12;
+
+int BalancedAssignment::getMoves(){
+	return moves;
+}
+
+void BalancedAssignment::updateArcs(int u){
+	for(int v=0; v<nClusters; v++){
+		arcCost[u*nClusters + v] = DBL_MAX;
+		arcPoint[u*nClusters + v] = -1;
+	}
+	for(size_t m=0; m<members[u].size(); m++){
+		const vector<double>& c = cost[members[u][m]];
+		for(int v=0; v<nClusters; v++){
+			if(v == u) continue;
+			double gain = c[v] - c[u];
+			if(gain < arcCost[u*nClusters + v]){
+				arcCost[u*nClusters + v] = gain;
+				arcPoint[u*nClusters + v] = m;
+			}
+		}
+	}
+}
+
+// Bellman-Ford from a virtual source joined to every node. Returns the most
+// recently relaxed cycle if one is still negative after k rounds.
+bool BalancedAssignment::findNegativeCycle(vector<int>& cycle){
+	vector<double> dist(nClusters, 0.0);
+	vector<int> pred(nClusters, -1);
+	int last = -1;
+	for(int round=0; round<nClusters; round++){
+		last = -1;
+		for(int u=0; u<nClusters; u++){
+			for(int v=0; v<nClusters; v++){
+				double w = arcCost[u*nClusters + v];
+				if(u == v || w == DBL_MAX) continue;
+				if(dist[u] + w < dist[v] - 1e-15*fabs(dist[v])){
+					dist[v] = dist[u] + w;
+					pred[v] = u;
+					last = v;
+				}
+			}
+		}
+		if(last == -1) return false;
+	}
+
+	// Walking back k steps from a node relaxed in the last round lands on the cycle
+	int v = last;
+	for(int i=0; i<nClusters; i++) v = pred[v];
+
+	cycle.clear();
+	int u = v;
+	do{
+		cycle.push_back(u);
+		u = pred[u];
+	}while(u != v);
+	reverse(cycle.begin(), cycle.end());
+	return true;
+}
+
+bool BalancedAssignment::polish(Solution& solution){
+	int n = solution.nDataPoints;
+	nClusters = solution.nClusters;
+	moves = 0;
+
+	// ||x_i - mu_c||^2 = sc[i][c]/|c| - W_c/|c|^2 with W_c the pair sum of c
+	vector<double> pairSum(nClusters, 0.0);
+	for(int i=0; i<n; i++){
+		pairSum[solution.assignment[i]] += solution.sc[i][solution.assignment[i]] / 2.0;
+	}
+	cost.assign(n, vector<double>(nClusters));
+	members.assign(nClusters, vector<int>());
+	double total = 0.0;
+	for(int i=0; i<n; i++){
+		for(int c=0; c<nClusters; c++){
+			double size = solution.clusterSizes[c];
+			cost[i][c] = size > 0 ? solution.sc[i][c]/size - pairSum[c]/(size*size) : 0.0;
+		}
+		members[solution.assignment[i]].push_back(i);
+		total += cost[i][solution.assignment[i]];
+	}
+
+	arcCost.assign(nClusters*nClusters, DBL_MAX);
+	arcPoint.assign(nClusters*nClusters, -1);
+	for(int u=0; u<nClusters; u++){
+		updateArcs(u);
+	}
+
+	vector<int> cycle;
+	while(findNegativeCycle(cycle)){
+		double gain = 0.0;
+		for(size_t t=0; t<cycle.size(); t++){
+			gain += arcCost[cycle[t]*nClusters + cycle[(t+1)%cycle.size()]];
+		}
+		if(gain > -CYCLE_TOLERANCE*fabs(total)) break;
+
+		// Pick every moving point before changing any member list
+		vector<int> moving(cycle.size());
+		for(size_t t=0; t<cycle.size(); t++){
+			int u = cycle[t], v = cycle[(t+1)%cycle.size()];
+			moving[t] = members[u][arcPoint[u*nClusters + v]];
+		}
+		for(size_t t=0; t<cycle.size(); t++){
+			int u = cycle[t], v = cycle[(t+1)%cycle.size()];
+			vector<int>& from = members[u];
+			from.erase(find(from.begin(), from.end(), moving[t]));
+			members[v].push_back(moving[t]);
+			solution.assignment[moving[t]] = v;
+			moves++;
+		}
+		for(size_t t=0; t<cycle.size(); t++){
+			updateArcs(cycle[t]);
+		}
+	}
+
+	if(moves > 0){
+		solution.initializeSc();
+		solution.evaluate();
+	}
+	return moves > 0;
+}
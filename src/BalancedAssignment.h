@@ -0,0 +1,43 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef BALANCEDASSIGNMENT_H_
+#define BALANCEDASSIGNMENT_H_
+
+#include <vector>
+#include "Solution.h"
+
+using namespace std;
+
+// Large-step polishing operator. With the centroids of the current clusters
+// fixed, it finds the reassignment of all points with minimum total squared
+// distance to their centroid that keeps every cluster size, i.e. a
+// transportation problem with k sinks. It is solved by cycle cancelling on
+// the k-node exchange graph, whose arc u->v carries the cheapest move of a
+// point of u into v; moving points along a negative cycle keeps the sizes.
+// Squared distances to the centroids come from sc, so no coordinates are
+// needed, and sc is rebuilt once at the end. The objective never increases.
+class BalancedAssignment {
+public:
+	// Returns true if the assignment changed.
+	bool polish(Solution& solution);
+	int getMoves();
+
+private:
+	int nClusters;
+	int moves;
+	vector< vector<double> > cost;     // squared distance of each point to each centroid
+	vector< vector<int> > members;
+	vector<double> arcCost;            // k x k, cheapest move from u to v
+	vector<int> arcPoint;              // index in members[u] of that point
+
+	void updateArcs(int u);
+	bool findNegativeCycle(vector<int>& cycle);
+};
+#endif /* BALANCEDASSIGNMENT_H_ */
@@ -0,0 +1,182 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "Construction.h"
+#include <algorithm>
+#include <float.h>
+
+using namespace std;
+
+bool parseConstructionMethod(const string& name, ConstructionMethod& method){
+	if(name == "random") method = CONSTRUCTION_RANDOM;
+	else if(name == "kmeans++") method = CONSTRUCTION_KMEANSPP;
+	else if(name == "regret") method = CONSTRUCTION_REGRET;
+	else return false;
+	return true;
+}
+
+Construction::Construction(Random* _random){
+	random = _random;
+}
+
+// k-means++ seeding: the first seed is uniform, every further seed is drawn
+// with probability proportional to its squared distance to the closest seed.
+vector<int> Construction::chooseSeeds(Solution& solution){
+	int n = solution.nDataPoints;
+	DistanceMatrix* distances = solution.distances;
+
+	vector<int> seeds;
+	seeds.push_back(random->get_rand(n) - 1);
+	vector<double> closest(n);
+	distances->useRow(seeds[0]);
+	for(int i=0; i<n; i++){
+		closest[i] = distances->getDistance(seeds[0], i);
+	}
+
+	while((int)seeds.size() < solution.nClusters){
+		double total = 0.0;
+		for(int i=0; i<n; i++) total += closest[i];
+
+		int seed = -1;
+		if(total > 0){
+			double target = random->get_rand01() * total;
+			for(int i=0; i<n && seed == -1; i++){
+				target -= closest[i];
+				if(target <= 0 && closest[i] > 0) seed = i;
+			}
+		}
+		if(seed == -1){
+			// Fewer distinct points than clusters (or rounding at the tail):
+			// fall back to the farthest point not chosen yet.
+			for(int i=0; i<n; i++){
+				if(find(seeds.begin(), seeds.end(), i) == seeds.end() && (seed == -1 || closest[i] > closest[seed])) seed = i;
+			}
+		}
+
+		seeds.push_back(seed);
+		distances->useRow(seed);
+		for(int i=0; i<n; i++){
+			closest[i] = min(closest[i], distances->getDistance(seed, i));
+		}
+	}
+	return seeds;
+}
+
+// Assigns (point, seed) pairs by increasing distance while the cluster of the
+// seed still has room, which always ends with exactly balanced clusters.
+void Construction::kMeansPlusPlus(Solution& solution){
+	int n = solution.nDataPoints;
+	int k = solution.nClusters;
+	vector<int> seeds = chooseSeeds(solution);
+
+	vector<Pair> candidates;
+	candidates.reserve((size_t)n*k);
+	for(int c=0; c<k; c++){
+		solution.distances->useRow(seeds[c]);
+		for(int i=0; i<n; i++){
+			candidates.push_back(Pair(i*k + c, solution.distances->getDistance(seeds[c], i)));
+		}
+	}
+	sort(candidates.begin(), candidates.end());
+
+	for(int i=0; i<n; i++) solution.assignment[i] = -1;
+	for(int c=0; c<k; c++) solution.clusterSizes[c] = 0;
+
+	for(size_t p=0; p<candidates.size(); p++){
+		int i = candidates[p].getId() / k;
+		int c = candidates[p].getId() % k;
+		if(solution.assignment[i] != -1 || solution.clusterSizes[c] >= solution.targetSize(c)) continue;
+		solution.assignment[i] = c;
+		solution.clusterSizes[c]++;
+	}
+
+	solution.initializeSc();
+	solution.evaluate();
+}
+
+// Repeatedly places the unassigned point with the largest regret, the gap
+// between its cheapest and second cheapest open cluster, into its cheapest
+// one. Costs are exact objective increases, kept current through sc, which
+// is built along the way. O(n^2 k) overall.
+void Construction::regret(Solution& solution){
+	int n = solution.nDataPoints;
+	int k = solution.nClusters;
+	DistanceMatrix* distances = solution.distances;
+	vector<int> seeds = chooseSeeds(solution);
+
+	for(int i=0; i<n; i++){
+		solution.assignment[i] = -1;
+		for(int c=0; c<k; c++) solution.sc[i][c] = 0.0;
+	}
+	for(int c=0; c<k; c++) solution.clusterSizes[c] = 0;
+
+	vector<double> pairSum(k, 0.0);
+	vector<int> unassigned;
+	unassigned.reserve(n);
+
+	// Place the seeds first, then every other point by regret
+	for(int c=0; c<k; c++){
+		solution.assignment[seeds[c]] = c;
+	}
+	for(int c=0; c<k; c++){
+		pairSum[c] += solution.sc[seeds[c]][c];
+		solution.clusterSizes[c]++;
+		distances->useRow(seeds[c]);
+		for(int j=0; j<n; j++){
+			solution.sc[j][c] += distances->getDistance(seeds[c], j);
+		}
+	}
+	for(int i=0; i<n; i++){
+		if(solution.assignment[i] == -1) unassigned.push_back(i);
+	}
+
+	while(!unassigned.empty()){
+		double bestRegret = -1.0;
+		double bestCost = DBL_MAX;
+		int bestIndex = -1, bestCluster = -1;
+		for(size_t u=0; u<unassigned.size(); u++){
+			int i = unassigned[u];
+			double first = DBL_MAX, second = DBL_MAX;
+			int firstCluster = -1;
+			for(int c=0; c<k; c++){
+				if(solution.clusterSizes[c] >= solution.targetSize(c)) continue;
+				double cost = (pairSum[c] + solution.sc[i][c]) / (solution.clusterSizes[c] + 1) - pairSum[c] / solution.clusterSizes[c];
+				if(cost < first){
+					second = first;
+					first = cost;
+					firstCluster = c;
+				}else if(cost < second){
+					second = cost;
+				}
+			}
+			double regretValue = second == DBL_MAX ? DBL_MAX : second - first;
+			if(regretValue > bestRegret || (regretValue == bestRegret && first < bestCost)){
+				bestRegret = regretValue;
+				bestCost = first;
+				bestIndex = u;
+				bestCluster = firstCluster;
+			}
+		}
+
+		int i = unassigned[bestIndex];
+		unassigned[bestIndex] = unassigned.back();
+		unassigned.pop_back();
+
+		solution.assignment[i] = bestCluster;
+		pairSum[bestCluster] += solution.sc[i][bestCluster];
+		solution.clusterSizes[bestCluster]++;
+		distances->useRow(i);
+		for(int j=0; j<n; j++){
+			solution.sc[j][bestCluster] += distances->getDistance(i, j);
+		}
+	}
+
+	solution.buildMembers();
+	solution.evaluate();
+}
@@ -0,0 +1,44 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef CONSTRUCTION_H_
+#define CONSTRUCTION_H_
+
+#include <vector>
+#include <string>
+#include "Solution.h"
+#include "Random.h"
+
+using namespace std;
+
+enum ConstructionMethod {
+	CONSTRUCTION_RANDOM,   // random shuffle split into balanced clusters
+	CONSTRUCTION_KMEANSPP, // k-means++ seeds, then capacity-constrained greedy
+	CONSTRUCTION_REGRET    // k-means++ seeds, then regret-based greedy
+};
+
+// Converts "random", "kmeans++" or "regret"; returns false for other names.
+bool parseConstructionMethod(const string& name, ConstructionMethod& method);
+
+// Constructive heuristics producing exactly balanced initial solutions that
+// start closer to a local optimum than a random assignment. Both fill the
+// assignment, clusterSizes, sc and solutionValue of the solution.
+class Construction {
+public:
+	Construction(Random* _random);
+
+	void kMeansPlusPlus(Solution& solution);
+	void regret(Solution& solution);
+
+private:
+	Random* random;
+
+	vector<int> chooseSeeds(Solution& solution);
+};
+#endif /* CONSTRUCTION_H_ */
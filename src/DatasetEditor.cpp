@@ -0,0 +1,84 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "DatasetEditor.h"
+#include "OnlineInsertion.h"
+
+using namespace std;
+
+DatasetEditor::DatasetEditor(DistanceMatrix* _distances, int _repairMoves){
+	distances = _distances;
+	repairMoves = _repairMoves;
+	moves = 0;
+}
+
+int DatasetEditor::getMoves(){
+	return moves;
+}
+
+bool DatasetEditor::validEdits(int nPoints, const vector<DatasetEdit>& edits){
+	for(size_t e=0; e<edits.size(); e++){
+		if(edits[e].type == EDIT_ADD){
+			nPoints++;
+			continue;
+		}
+		if(edits[e].point < 0 || edits[e].point >= nPoints) return false;
+		if(edits[e].type == EDIT_REMOVE) nPoints--;
+	}
+	return true;
+}
+
+bool DatasetEditor::apply(Solution& solution, const vector<DatasetEdit>& edits){
+	moves = 0;
+	if(!distances->editable() || !validEdits(solution.nDataPoints, edits)) return false;
+
+	vector<double> before;
+	for(size_t e=0; e<edits.size(); e++){
+		const DatasetEdit& edit = edits[e];
+		int n = solution.nDataPoints;
+		if(edit.type == EDIT_ADD){
+			// Assigned with the other new points once all edits are in
+			if(!distances->addPoints(edit.coordinates, 1)) return false;
+			solution.resize(n + 1);
+			continue;
+		}
+
+		int p = edit.point;
+		if(edit.type == EDIT_REMOVE){
+			// The solution reads the distances of p before the matrix drops it
+			solution.removePoint(p);
+			if(!distances->removePoint(p)) return false;
+			continue;
+		}
+
+		// Every distance of p changes by new - old, in sc[p] and in column c of sc
+		before.resize(n);
+		for(int j=0; j<n; j++){
+			before[j] = distances->getDistance(p, j);
+		}
+		if(!distances->updatePoint(p, edit.coordinates)) return false;
+		int c = solution.assignment[p];
+		if(c < 0) continue;
+		for(int j=0; j<n; j++){
+			int cj = solution.assignment[j];
+			if(cj < 0 || j == p) continue;
+			double change = distances->getDistance(p, j) - before[j];
+			solution.sc[p][cj] += change;
+			solution.sc[j][c] += change;
+		}
+	}
+
+	vector<int> added;
+	for(int i=0; i<solution.nDataPoints; i++){
+		if(solution.assignment[i] < 0) added.push_back(i);
+	}
+	OnlineInsertion(repairMoves).assignPoints(solution, added);
+	moves = solution.rebalance();
+	return true;
+}
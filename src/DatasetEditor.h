@@ -0,0 +1,59 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef DATASETEDITOR_H_
+#define DATASETEDITOR_H_
+
+#include <vector>
+#include "DistanceMatrix.h"
+#include "Solution.h"
+
+using namespace std;
+
+enum EditType {
+	EDIT_ADD,     // appends a point with the given coordinates
+	EDIT_REMOVE,  // deletes point; the last point takes its index
+	EDIT_UPDATE   // gives point new coordinates
+};
+
+struct DatasetEdit {
+	EditType type;
+	int point;                   // ignored by EDIT_ADD
+	const double* coordinates;   // nDimensions values, ignored by EDIT_REMOVE
+};
+
+// Brings a solved instance up to date with a list of edits, applied in
+// order, without rebuilding it. Only the distances and sc entries of the
+// edited points are touched: an update patches its row and column of the
+// matrix and adds the change of each distance to sc, in O(nd); a removal
+// subtracts its distances from sc and moves the last point into its index;
+// an addition only appends its row. Added points are then assigned as by
+// OnlineInsertion, and clusters left oversized by removals hand their extra
+// points to the others with the fewest, cheapest moves (Solution::rebalance).
+class DatasetEditor {
+public:
+	DatasetEditor(DistanceMatrix* _distances, int _repairMoves);
+
+	// solution must be balanced with a consistent sc on the matrix. Returns
+	// false, changing nothing, if the matrix is not editable (see
+	// DistanceMatrix::editable) or an edit fails validEdits; a matrix edit
+	// that still fails stops the apply with false.
+	bool apply(Solution& solution, const vector<DatasetEdit>& edits);
+	// Checks every index against the number of points left by the edits
+	// before it, starting from nPoints.
+	static bool validEdits(int nPoints, const vector<DatasetEdit>& edits);
+	// Points moved to restore the balance by the last apply.
+	int getMoves();
+
+private:
+	DistanceMatrix* distances;
+	int repairMoves;
+	int moves;
+};
+#endif /* DATASETEDITOR_H_ */
@@ -0,0 +1,62 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "DeltaKernel.h"
+#include "VectorKernels.h"
+
+using namespace std;
+
+void DeltaKernel::load(Solution& _solution, int i, int _clusterB){
+	solution = &_solution;
+	point = i;
+	clusterA = solution->assignment[i];
+	clusterB = _clusterB;
+	invA = 1.0 / solution->clusterSizes[clusterA];
+	invB = 1.0 / solution->clusterSizes[clusterB];
+	invSum = invA + invB;
+	base = solution->sc[i][clusterB] * invB - solution->sc[i][clusterA] * invA;
+}
+
+void DeltaKernel::evaluate(const int* points, int count){
+	double** sc = solution->sc;
+	DistanceMatrix* distances = solution->distances;
+	for(int m=0; m<count; m++){
+		int j = points[m];
+		columnA[m] = sc[j][clusterA];
+		columnB[m] = sc[j][clusterB];
+		distance[m] = distances->getDistance(point, j);
+	}
+
+	// Contiguous and branch-free, so it is vectorized for the selected level
+	vectorKernels().swapDeltas(deltas, columnA, columnB, distance, count, base, invA, invB, invSum);
+}
+
+int DeltaKernel::firstImproving(const int* points, int count, double threshold, double& delta){
+	evaluate(points, count);
+	for(int m=0; m<count; m++){
+		if(deltas[m] < threshold){
+			delta = deltas[m];
+			return m;
+		}
+	}
+	return -1;
+}
+
+int DeltaKernel::bestImproving(const int* points, int count, double threshold, double& delta){
+	evaluate(points, count);
+	int best = -1;
+	for(int m=0; m<count; m++){
+		if(deltas[m] < threshold){
+			threshold = deltas[m];
+			best = m;
+		}
+	}
+	if(best != -1) delta = deltas[best];
+	return best;
+}
@@ -0,0 +1,51 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef DELTAKERNEL_H_
+#define DELTAKERNEL_H_
+
+#include "Solution.h"
+
+using namespace std;
+
+// Evaluates the swap of a fixed point i, in cluster A, with a block of points
+// of another cluster B. The swap delta
+//   (sc[j][A] - sc[i][A] - d_ij)/|A| + (sc[i][B] - sc[j][B] - d_ij)/|B|
+// is rewritten as
+//   base + sc[j][A]/|A| - sc[j][B]/|B| - d_ij (1/|A| + 1/|B|)
+// with base depending on i only, so that after the columns sc[.][A],
+// sc[.][B] and the distances d_i. are gathered into contiguous buffers the
+// block is one multiply-add loop without divisions the compiler vectorizes.
+class DeltaKernel {
+public:
+	static const int BLOCK = 64;
+
+	// Prepares the swaps of point i with points of clusterB.
+	void load(Solution& solution, int i, int clusterB);
+	// Index in points of the first swap with delta below threshold, or -1.
+	// count must not exceed BLOCK.
+	int firstImproving(const int* points, int count, double threshold, double& delta);
+	// Index in points of the swap with the smallest delta if it is below
+	// threshold, or -1.
+	int bestImproving(const int* points, int count, double threshold, double& delta);
+
+private:
+	Solution* solution;
+	int point;
+	int clusterA, clusterB;
+	double base, invA, invB, invSum;
+
+	double columnA[BLOCK];
+	double columnB[BLOCK];
+	double distance[BLOCK];
+	double deltas[BLOCK];
+
+	void evaluate(const int* points, int count);
+};
+#endif /* DELTAKERNEL_H_ */
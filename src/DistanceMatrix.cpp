@@ -10,43 +10,619 @@
 #include "DistanceMatrix.h"
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include "Point.h"
+#include "VectorKernels.h"
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 
-DistanceMatrix::DistanceMatrix(vector<Point>* dataset){
+bool parseDistanceStorage(const string& name, DistanceStorage& storageType){
+	if(name == "double") storageType = STORAGE_DOUBLE;
+	else if(name == "float") storageType = STORAGE_FLOAT;
+	else if(name == "mapped") storageType = STORAGE_MAPPED;
+	else if(name == "onthefly") storageType = STORAGE_ONTHEFLY;
+	else return false;
+	return true;
+}
+
+const char* storageName(DistanceStorage storageType){
+	switch(storageType){
+	case STORAGE_DOUBLE: return "double triangle";
+	case STORAGE_FLOAT: return "float triangle";
+	case STORAGE_MAPPED: return "mapped";
+	case STORAGE_ONTHEFLY: return "on the fly";
+	}
+	return "unknown";
+}
+
+static string mappedPath;
+static size_t mappedCache = 0;
+
+void setMappedStorage(const string& directory, size_t cacheBytes){
+	mappedPath = directory;
+	mappedCache = cacheBytes;
+}
+
+size_t mappedCacheBytes(){
+	return mappedCache;
+}
+
+string mappedDirectory(){
+	if(!mappedPath.empty()) return mappedPath;
+	const char* tmp = getenv("TMPDIR");
+	return tmp != NULL && *tmp != '\0' ? tmp : "/tmp";
+}
+
+DistanceMatrix::DistanceMatrix(vector<Point>* dataset, int nThreads, DistanceStorage _storageType){
 	nV = dataset->size();
+	storageType = _storageType;
+	rowCacheBytes = 0;
+	nDimensions = nV > 0 ? (*dataset)[0].getDimensions() : 0;
+	allocate();
 
-	adj = new double*[nV];
+	vector<double> coordinates((size_t)nV*nDimensions);
 	for(int i=0; i<nV; i++){
-		adj[i] = new double[nV-i];
+		for(int d=0; d<nDimensions; d++){
+			coordinates[(size_t)i*nDimensions + d] = (*dataset)[i].getCoordinatesAt(d);
+		}
 	}
+	build(coordinates, nThreads);
+}
+
+DistanceMatrix::DistanceMatrix(int nPoints){
+	nV = nPoints;
+	storageType = STORAGE_DOUBLE;
+	nDimensions = 0;
+	allocate();
 
 	for(int i=0; i<nV; i++){
-		setDistance(i, i, 0.0);
-		for(int j=i+1; j<nV; j++){
-			setDistance(i, j, (*dataset)[i].getSquaredDistance((*dataset)[j]));
+		for(int j=0; j<=i; j++){
+			setDistance(i, j, 0.0);
 		}
 	}
 }
 
-DistanceMatrix::~DistanceMatrix(){
+DistanceMatrix::DistanceMatrix(const double* coordinates, int nPoints, int _nDimensions, int nThreads,
+		DistanceStorage _storageType, size_t _rowCacheBytes){
+	nV = nPoints;
+	storageType = _storageType;
+	nDimensions = _nDimensions;
+	rowCacheBytes = _rowCacheBytes;
+	allocate();
+
+	vector<double> copy(coordinates, coordinates + (size_t)nV*nDimensions);
+	build(copy, nThreads);
+}
+
+// Side of the square tiles of the lower triangle handled as one unit of work,
+// and number of dimensions per pass over a tile.
+static const int TILE = 64;
+static const int DIMENSION_BLOCK = 128;
+
+// Pairs with ||x-y||^2 below this fraction of ||x||^2+||y||^2 lose too many
+// digits to cancellation in the dot-product formula and are recomputed directly.
+static const double CANCELLATION_THRESHOLD = 1e-4;
+
+// Fills the matrix from row-major coordinates, which are centred and then
+// kept as points. ||x-y||^2 = ||x||^2 + ||y||^2 - 2 x.y is evaluated on
+// TILE x TILE tiles: for each block of dimensions the column points are
+// transposed so that the dot products of one row point with the whole tile
+// are accumulated in a contiguous, vectorizable loop. Threads take rows of
+// tiles from a shared counter, longest rows first.
+void DistanceMatrix::build(vector<double>& coordinates, int nThreads){
+	// Centre each dimension; the mean is rounded when all values are integers
+	// so that integer data keeps exact distances.
+	centre.assign(nDimensions, 0.0);
+	for(int d=0; d<nDimensions; d++){
+		double mean = 0.0;
+		bool integral = true;
+		for(int i=0; i<nV; i++){
+			double x = coordinates[(size_t)i*nDimensions + d];
+			mean += x;
+			integral = integral && x == floor(x);
+		}
+		mean = nV > 0 ? mean / nV : 0.0;
+		if(integral) mean = floor(mean + 0.5);
+		for(int i=0; i<nV; i++){
+			coordinates[(size_t)i*nDimensions + d] -= mean;
+		}
+		centre[d] = mean;
+	}
+	points.swap(coordinates);
+	if(storageType == STORAGE_ONTHEFLY) return;
+	if(storageType == STORAGE_MAPPED){
+		buildMapped(nThreads);
+		return;
+	}
+
+	vector<double> norms(nV);
+	for(int i=0; i<nV; i++){
+		const double* x = &points[(size_t)i*nDimensions];
+		double sum = 0.0;
+		for(int d=0; d<nDimensions; d++) sum += x[d]*x[d];
+		norms[i] = sum;
+	}
+
+	int nTileRows = (nV + TILE - 1) / TILE;
+	if(nThreads <= 0) nThreads = thread::hardware_concurrency();
+	nThreads = max(1, min(nThreads, nTileRows));
+
+	atomic<int> nextTileRow(0);
+	auto worker = [&](){
+		int tileRow;
+		while((tileRow = nextTileRow++) < nTileRows){
+			buildTiles(points.data(), norms.data(), nTileRows - 1 - tileRow);
+		}
+	};
+	vector<thread> threads;
+	for(int t=1; t<nThreads; t++){
+		threads.push_back(thread(worker));
+	}
+	worker();
+	for(size_t t=0; t<threads.size(); t++){
+		threads[t].join();
+	}
+}
+
+// Computes the tiles (tileRow, tileColumn <= tileRow) of the lower triangle.
+void DistanceMatrix::buildTiles(const double* coordinates, const double* norms, int tileRow){
+	int rowBegin = tileRow*TILE, rowEnd = min(nV, rowBegin + TILE);
+	vector<double> transposed((size_t)DIMENSION_BLOCK*TILE);
+	vector<double> dot((size_t)TILE*TILE);
+
+	for(int columnBegin = 0; columnBegin <= rowBegin; columnBegin += TILE){
+		int columnEnd = min(nV, columnBegin + TILE);
+		int width = columnEnd - columnBegin;
+		fill(dot.begin(), dot.end(), 0.0);
+
+		for(int dBegin = 0; dBegin < nDimensions; dBegin += DIMENSION_BLOCK){
+			int dEnd = min(nDimensions, dBegin + DIMENSION_BLOCK);
+			for(int j=0; j<width; j++){
+				const double* y = coordinates + (size_t)(columnBegin + j)*nDimensions;
+				for(int d=dBegin; d<dEnd; d++){
+					transposed[(size_t)(d - dBegin)*TILE + j] = y[d];
+				}
+			}
+			vectorKernels().tileProducts(dot.data(), transposed.data(), coordinates, nDimensions,
+					rowBegin, rowEnd, dBegin, dEnd, width, TILE);
+		}
+
+		for(int i=rowBegin; i<rowEnd; i++){
+			const double* x = coordinates + (size_t)i*nDimensions;
+			const double* dotRow = &dot[(size_t)(i - rowBegin)*TILE];
+			for(int j=columnBegin; j<min(i+1, columnEnd); j++){
+				double scale = norms[i] + norms[j];
+				double distance = scale - 2.0*dotRow[j - columnBegin];
+				if(i == j){
+					distance = 0.0;
+				}else if(distance < CANCELLATION_THRESHOLD*scale){
+					const double* y = coordinates + (size_t)j*nDimensions;
+					distance = 0.0;
+					for(int d=0; d<nDimensions; d++){
+						distance += (x[d] - y[d])*(x[d] - y[d]);
+					}
+				}
+				if(storageType == STORAGE_FLOAT) adjSingle[i][j] = (float)distance;
+				else adj[i][j] = distance;
+			}
+		}
+	}
+}
+
+// Bytes of rows computed before each write to the file of STORAGE_MAPPED.
+static const size_t MAPPED_BUILD_BLOCK = 64 << 20;
+
+// Fewest rows the cache of STORAGE_MAPPED holds, whatever its byte budget:
+// a swap reads two rows and the scan reads ahead a third.
+static const int MAPPED_MIN_ROWS = 4;
+
+// Writes the full rows to the file a block of rows at a time, then maps it.
+// Threads take rows from a shared counter; a row is accumulated one
+// dimension at a time against the transposed coordinates, which keeps the
+// inner loop contiguous and the distances exact. Kernel read-ahead is
+// turned off, as the cache reads ahead itself.
+void DistanceMatrix::buildMapped(int nThreads){
+	size_t rowBytes = rowStride * sizeof(double);
+	if(nThreads <= 0) nThreads = thread::hardware_concurrency();
+	nThreads = max(1, min(nThreads, nV));
+	int blockRows = max(nThreads, (int)min((size_t)nV, MAPPED_BUILD_BLOCK / rowBytes));
+
+	vector<double> transposed((size_t)nDimensions*nV);
 	for(int i=0; i<nV; i++){
-		delete [] adj[i];
+		for(int d=0; d<nDimensions; d++){
+			transposed[(size_t)d*nV + i] = points[(size_t)i*nDimensions + d];
+		}
+	}
+
+	vector<double> block((size_t)blockRows * rowStride, 0.0);
+	for(int first = 0; first < nV; first += blockRows){
+		int last = min(nV, first + blockRows);
+		atomic<int> nextRow(first);
+		auto worker = [&](){
+			int i;
+			while((i = nextRow++) < last){
+				vectorKernels().squaredDistances(&block[(size_t)(i - first)*rowStride], transposed.data(),
+						&points[(size_t)i*nDimensions], nDimensions, nV);
+			}
+		};
+		vector<thread> threads;
+		for(int t=1; t<nThreads; t++){
+			threads.push_back(thread(worker));
+		}
+		worker();
+		for(size_t t=0; t<threads.size(); t++){
+			threads[t].join();
+		}
+
+		const char* data = (const char*)block.data();
+		size_t bytes = (size_t)(last - first) * rowBytes;
+		off_t offset = (off_t)first * rowBytes;
+		while(bytes > 0){
+			ssize_t written = pwrite(file, data, bytes, offset);
+			if(written <= 0) throw runtime_error("cannot write the distance file in " + mappedDirectory());
+			data += written;
+			bytes -= written;
+			offset += written;
+		}
+		// Written back and dropped, so the build never holds more than a
+		// block and later reads find only what the cache brought in
+		fdatasync(file);
+		posix_fadvise(file, (off_t)first * rowBytes, (off_t)(last - first) * rowBytes, POSIX_FADV_DONTNEED);
+	}
+
+	size_t fileBytes = (size_t)nV * rowBytes;
+	void* mapping = mmap(NULL, fileBytes, PROT_READ, MAP_SHARED, file, 0);
+	if(mapping == MAP_FAILED) throw runtime_error("cannot map the distance file");
+	madvise(mapping, fileBytes, MADV_RANDOM);
+	mapped = (double*)mapping;
+
+	size_t cacheBytes = rowCacheBytes > 0 ? rowCacheBytes : mappedCache;
+	if(cacheBytes == 0) cacheBytes = (size_t)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE) / 4;
+	cacheRows = (int)min((size_t)nV, max((size_t)MAPPED_MIN_ROWS, cacheBytes / rowBytes));
+	slotRow.assign(cacheRows, -1);
+	slotReferenced.assign(cacheRows, 0);
+	rowSlot.assign(nV, -1);
+	residentPages.resize(rowBytes / sysconf(_SC_PAGESIZE));
+}
+
+// Announces row i. A row not cached yet takes the slot of the first row the
+// clock finds unreferenced since its last pass, whose pages are dropped from
+// the mapping and from the page cache. The pages of the new row are read
+// ahead with WILLNEED, so a prefetch returns at once and its reads overlap
+// the search; those not in the page cache are counted as read.
+void DistanceMatrix::cacheRow(int i, bool prefetch){
+	lock_guard<mutex> guard(cacheLock);
+	int slot = rowSlot[i];
+	if(!prefetch) cacheStats.rowReads++;
+	if(slot >= 0){
+		if(!prefetch){
+			cacheStats.rowHits++;
+			slotReferenced[slot] = 1;
+		}
+		return;
+	}
+
+	while(slotRow[clockHand] >= 0 && slotReferenced[clockHand]){
+		slotReferenced[clockHand] = 0;
+		clockHand = (clockHand + 1) % cacheRows;
+	}
+	slot = clockHand;
+	clockHand = (clockHand + 1) % cacheRows;
+
+	size_t rowBytes = rowStride * sizeof(double);
+	if(slotRow[slot] >= 0){
+		int evicted = slotRow[slot];
+		madvise(mapped + (size_t)evicted*rowStride, rowBytes, MADV_DONTNEED);
+		posix_fadvise(file, (off_t)evicted * rowBytes, rowBytes, POSIX_FADV_DONTNEED);
+		rowSlot[evicted] = -1;
+		cacheStats.evictions++;
+	}
+
+	double* row = mapped + (size_t)i*rowStride;
+	if(mincore(row, rowBytes, residentPages.data()) == 0){
+		size_t pageSize = rowBytes / residentPages.size();
+		for(size_t p=0; p<residentPages.size(); p++){
+			if(!(residentPages[p] & 1)) cacheStats.bytesRead += pageSize;
+		}
+	}
+	madvise(row, rowBytes, MADV_WILLNEED);
+	slotRow[slot] = i;
+	rowSlot[i] = slot;
+	slotReferenced[slot] = !prefetch;
+	if(prefetch) cacheStats.prefetches++;
+}
+
+DistanceCacheStats DistanceMatrix::getCacheStats(){
+	lock_guard<mutex> guard(cacheLock);
+	return cacheStats;
+}
+
+DistanceMatrix::DistanceMatrix(const double* matrix, int nPoints){
+	nV = nPoints;
+	storageType = STORAGE_DOUBLE;
+	nDimensions = 0;
+	adjSingle = NULL;
+	mapped = NULL;
+	file = -1;
+	ownsStorage = false;
+	storage.data = NULL;
+	storage.bytes = 0;
+	storage.backing = BACKING_HEAP;
+
+	// Row i of the lower triangle is the start of row i of the full matrix,
+	// so adj[i][j] reads matrix[i][j] in place.
+	adj = new double*[nV];
+	for(int i=0; i<nV; i++){
+		adj[i] = const_cast<double*>(matrix) + (size_t)i*nV;
+	}
+}
+
+void DistanceMatrix::allocate(){
+	ownsStorage = true;
+	adj = NULL;
+	adjSingle = NULL;
+	mapped = NULL;
+	file = -1;
+	storage.data = NULL;
+	storage.bytes = 0;
+	storage.backing = BACKING_HEAP;
+	size_t triangle = (size_t)nV*(nV+1)/2;
+
+	if(storageType == STORAGE_DOUBLE){
+		storage = allocateBlock(sizeof(double) * triangle);
+		double* row = (double*)storage.data;
+		adj = new double*[nV];
+		for(int i=0; i<nV; i++){
+			adj[i] = row;
+			row += i+1;
+		}
+	}else if(storageType == STORAGE_FLOAT){
+		storage = allocateBlock(sizeof(float) * triangle);
+		float* row = (float*)storage.data;
+		adjSingle = new float*[nV];
+		for(int i=0; i<nV; i++){
+			adjSingle[i] = row;
+			row += i+1;
+		}
+	}else if(storageType == STORAGE_MAPPED){
+		// Rows are page aligned, so each can be dropped on its own. The file
+		// is unlinked at once and goes away with the process.
+		size_t pageDoubles = sysconf(_SC_PAGESIZE) / sizeof(double);
+		rowStride = ((size_t)nV + pageDoubles - 1) / pageDoubles * pageDoubles;
+		string path = mappedDirectory() + "/lima_vns_XXXXXX";
+		vector<char> name(path.begin(), path.end());
+		name.push_back('\0');
+		file = mkstemp(name.data());
+		if(file < 0) throw runtime_error("cannot create a distance file in " + mappedDirectory());
+		unlink(name.data());
+		if(ftruncate(file, (off_t)nV * rowStride * sizeof(double)) != 0){
+			close(file);
+			throw runtime_error("cannot size the distance file in " + mappedDirectory());
+		}
+		clockHand = 0;
+		cacheStats.rowReads = 0;
+		cacheStats.rowHits = 0;
+		cacheStats.prefetches = 0;
+		cacheStats.evictions = 0;
+		cacheStats.bytesRead = 0;
+	}
+}
+
+DistanceMatrix::~DistanceMatrix(){
+	if(ownsStorage){
+		releaseBlock(storage);
+	}
+	for(size_t e=0; e<extensions.size(); e++){
+		releaseBlock(extensions[e]);
+	}
+	if(mapped != NULL){
+		munmap(mapped, (size_t)nV * rowStride * sizeof(double));
+	}
+	if(file >= 0){
+		close(file);
 	}
 	delete [] adj;
+	delete [] adjSingle;
+}
+
+double DistanceMatrix::computeDistance(int i, int j){
+	if(i < j){
+		int t = i;
+		i = j;
+		j = t;
+	}
+	if(storageType == STORAGE_FLOAT){
+		return adjSingle[i][j];
+	}
+
+	const double* x = &points[(size_t)i*nDimensions];
+	const double* y = &points[(size_t)j*nDimensions];
+	double sum = 0.0;
+	for(int d=0; d<nDimensions; d++){
+		sum += (x[d] - y[d])*(x[d] - y[d]);
+	}
+	return sum;
+}
+
+MemoryBacking DistanceMatrix::getBacking(){
+	if(storageType == STORAGE_MAPPED) return BACKING_FILE;
+	return ownsStorage ? storage.backing : BACKING_HEAP;
+}
+
+const double* DistanceMatrix::getRow(int i, double* buffer){
+	if(storageType == STORAGE_DOUBLE){
+		return adj[i];
+	}
+	if(storageType == STORAGE_MAPPED){
+		cacheRow(i, false);
+		return mapped + (size_t)i*rowStride;
+	}
+	for(int j=0; j<=i; j++){
+		buffer[j] = computeDistance(i, j);
+	}
+	return buffer;
 }
 
-double DistanceMatrix::getDistance(int i, int j){
-	if(i<j){
-		return adj[i][j-i];
+bool DistanceMatrix::addPoints(const double* coordinates, int count){
+	if(count <= 0) return true;
+	if(!hasCoordinates() || storageType == STORAGE_MAPPED) return false;
+
+	int first = nV;
+	nV += count;
+	for(int i=0; i<count; i++){
+		for(int d=0; d<nDimensions; d++){
+			points.push_back(coordinates[(size_t)i*nDimensions + d] - centre[d]);
+		}
+	}
+	if(storageType == STORAGE_ONTHEFLY) return true;
+
+	// The new rows go into one block; only the row pointer arrays are copied
+	size_t entries = (size_t)count*first + (size_t)count*(count+1)/2;
+	size_t width = storageType == STORAGE_FLOAT ? sizeof(float) : sizeof(double);
+	MemoryBlock block = allocateBlock(width * entries);
+	extensions.push_back(block);
+	char* row = (char*)block.data;
+	if(storageType == STORAGE_FLOAT){
+		float** rows = new float*[nV];
+		copy(adjSingle, adjSingle + first, rows);
+		delete [] adjSingle;
+		adjSingle = rows;
 	}else{
-		return adj[j][i-j];
+		double** rows = new double*[nV];
+		copy(adj, adj + first, rows);
+		delete [] adj;
+		adj = rows;
 	}
+
+	for(int i=first; i<nV; i++){
+		const double* x = &points[(size_t)i*nDimensions];
+		if(storageType == STORAGE_FLOAT) adjSingle[i] = (float*)row;
+		else adj[i] = (double*)row;
+		row += width * (i+1);
+		for(int j=0; j<=i; j++){
+			const double* y = &points[(size_t)j*nDimensions];
+			double distance = 0.0;
+			for(int d=0; d<nDimensions; d++){
+				distance += (x[d] - y[d])*(x[d] - y[d]);
+			}
+			setDistance(i, j, distance);
+		}
+	}
+	return true;
+}
+
+bool DistanceMatrix::removePoint(int i){
+	bool coordinates = hasCoordinates();
+	if(!ownsStorage || storageType == STORAGE_MAPPED || (storageType == STORAGE_ONTHEFLY && !coordinates)) return false;
+
+	int last = nV - 1;
+	if(i != last){
+		// Row last is only read, the writes go to row i and column i
+		if(storageType != STORAGE_ONTHEFLY){
+			for(int j=0; j<last; j++){
+				if(j != i) setDistance(i, j, getDistance(last, j));
+			}
+		}
+		if(coordinates){
+			copy(points.begin() + (size_t)last*nDimensions, points.end(), points.begin() + (size_t)i*nDimensions);
+		}
+	}
+	if(coordinates) points.resize((size_t)last*nDimensions);
+	nV = last;
+	return true;
+}
+
+bool DistanceMatrix::updatePoint(int i, const double* coordinates){
+	if(!hasCoordinates() || storageType == STORAGE_MAPPED) return false;
+
+	double* x = &points[(size_t)i*nDimensions];
+	for(int d=0; d<nDimensions; d++){
+		x[d] = coordinates[d] - centre[d];
+	}
+	if(storageType == STORAGE_ONTHEFLY) return true;
+	for(int j=0; j<nV; j++){
+		const double* y = &points[(size_t)j*nDimensions];
+		double distance = 0.0;
+		for(int d=0; d<nDimensions; d++){
+			distance += (x[d] - y[d])*(x[d] - y[d]);
+		}
+		setDistance(i, j, distance);
+	}
+	return true;
 }
 
+DistanceStorage DistanceMatrix::getStorage(){
+	return storageType;
+}
+
+// Not available with STORAGE_ONTHEFLY, where distances follow the coordinates.
 void DistanceMatrix::setDistance(int i, int j, double d){
-	if(i<j){
-		adj[i][j-i] = d;
-	}else{
-		adj[j][i-j] = d;
+	if(i < j){
+		int t = i;
+		i = j;
+		j = t;
+	}
+	if(storageType == STORAGE_DOUBLE){
+		adj[i][j] = d;
+	}else if(storageType == STORAGE_FLOAT){
+		adjSingle[i][j] = (float)d;
+	}
+}
+
+int DistanceMatrix::getSize(){
+	return nV;
+}
+
+size_t DistanceMatrix::getBytes(){
+	size_t bytes = storage.bytes + (points.capacity() + centre.capacity()) * sizeof(double);
+	for(size_t e=0; e<extensions.size(); e++){
+		bytes += extensions[e].bytes;
+	}
+	if(adj) bytes += (size_t)nV * sizeof(double*);
+	if(adjSingle) bytes += (size_t)nV * sizeof(float*);
+	if(storageType == STORAGE_MAPPED){
+		bytes += (size_t)cacheRows * rowStride * sizeof(double) + rowSlot.capacity() * sizeof(int);
+	}
+	return bytes;
+}
+
+bool DistanceMatrix::hasCoordinates(){
+	return nDimensions > 0 && points.size() == (size_t)nV*nDimensions;
+}
+
+bool DistanceMatrix::editable(){
+	return hasCoordinates() && storageType != STORAGE_MAPPED;
+}
+
+const double* DistanceMatrix::getCoordinates(){
+	return points.data();
+}
+
+int DistanceMatrix::getDimensions(){
+	return nDimensions;
+}
+
+void DistanceMatrix::rankEntities(vector< vector<Pair> >& rankedEntities, int nNeighbours){
+	int kept = nNeighbours > 0 ? min(nNeighbours, nV-1) : nV-1;
+	rankedEntities.assign(nV, vector<Pair>());
+	vector<Pair> all;
+	all.reserve(nV-1);
+	for(int o=0; o<nV; o++){
+		all.clear();
+		for(int m=0; m<nV; m++){
+			if(o!=m){
+				Pair pair(m, getDistance(o,m));
+				all.push_back(pair);
+			}
+		}
+		if(kept == nV-1) sort(all.begin(), all.end());
+		else partial_sort(all.begin(), all.begin() + kept, all.end());
+		rankedEntities[o].assign(all.begin(), all.begin() + kept);
 	}
 }
@@ -11,19 +11,164 @@
 #define DISTANCEMATRIX_H
 
 #include <vector>
+#include <string>
+#include <mutex>
 #include "Point.h"
+#include "Pair.h"
+#include "Memory.h"
 
 using namespace std;
 
+// How the distances are kept: the lower triangle in double or in single
+// precision, the full matrix in a file, or only the coordinates, with every
+// distance recomputed on use. Row i of the triangle holds the distances of i
+// to the points j <= i, so points can be appended without moving the rows
+// already there.
+//
+// STORAGE_MAPPED is for matrices larger than the memory: every full row is
+// written, page aligned, to an unlinked file in the spill directory, which
+// is mapped read-only. Only the rows in an explicit cache stay resident;
+// evicted rows are dropped from the mapping and from the page cache, so
+// the footprint is the cache size rather than what the kernel would keep.
+// The hot loops read one point against all the others, so rows are the
+// unit of the cache: they announce the rows they read with useRow and the
+// next ones with prefetchRow, and read getDistance(fixed point, other).
+enum DistanceStorage {
+    STORAGE_DOUBLE,
+    STORAGE_FLOAT,
+    STORAGE_MAPPED,
+    STORAGE_ONTHEFLY
+};
+
+// Converts "double", "float", "mapped" or "onthefly"; returns false for other names.
+bool parseDistanceStorage(const string& name, DistanceStorage& storageType);
+const char* storageName(DistanceStorage storageType);
+
+// Process-wide settings of the matrices built with STORAGE_MAPPED afterwards:
+// the directory of their file and the bytes of rows their cache keeps, 0 for
+// a quarter of the physical memory. The directory defaults to $TMPDIR or /tmp.
+void setMappedStorage(const string& directory, size_t cacheBytes);
+string mappedDirectory();
+size_t mappedCacheBytes();
+
+struct DistanceCacheStats {
+    long rowReads;         // rows announced by useRow or getRow
+    long rowHits;          // of them, already in the cache
+    long prefetches;       // rows read ahead by prefetchRow
+    long evictions;
+    size_t bytesRead;      // of the rows loaded, the pages not in the page cache
+};
+
 class DistanceMatrix{
     int nV;
-    double **adj;
+    DistanceStorage storageType;
+    double **adj;          // STORAGE_DOUBLE
+    float **adjSingle;     // STORAGE_FLOAT
+    vector<double> points; // centred coordinates, row-major, when built from coordinates
+    vector<double> centre; // subtracted from every coordinate
+    int nDimensions;
+    bool ownsStorage;
+    MemoryBlock storage;   // the whole triangle, rows one after the other
+    vector<MemoryBlock> extensions;  // rows added by addPoints, one block per call
+
+    // STORAGE_MAPPED: the mapped file, rowStride doubles per row, and the
+    // row cache, a clock over cacheRows slots
+    double* mapped;
+    size_t rowStride;
+    size_t rowCacheBytes;  // 0 = mappedCacheBytes()
+    int file;
+    int cacheRows;
+    vector<int> slotRow;
+    vector<char> slotReferenced;
+    vector<int> rowSlot;
+    int clockHand;
+    DistanceCacheStats cacheStats;
+    vector<unsigned char> residentPages;  // mincore of one row
+    mutex cacheLock;
+
+    void allocate();
+    double computeDistance(int i, int j);
+    void build(vector<double>& coordinates, int nThreads);
+    void buildTiles(const double* coordinates, const double* norms, int tileRow);
+    void buildMapped(int nThreads);
+    void cacheRow(int i, bool prefetch);
 
 public:
-    DistanceMatrix(vector<Point>* dataset);
+    // The coordinate constructors compute the distances by tiles on nThreads
+    // threads (0 = all cores), see build, and keep them as storageType says.
+    DistanceMatrix(vector<Point>* dataset, int nThreads = 0, DistanceStorage _storageType = STORAGE_DOUBLE);
+    // Allocates a zeroed matrix for nPoints to be filled with setDistance.
+    DistanceMatrix(int nPoints);
+    // Builds the matrix from a row-major buffer of nPoints x nDimensions
+    // coordinates. A mapped matrix caches rowCacheBytes of rows, or the
+    // process setting when 0.
+    DistanceMatrix(const double* coordinates, int nPoints, int nDimensions, int nThreads = 0,
+            DistanceStorage _storageType = STORAGE_DOUBLE, size_t _rowCacheBytes = 0);
+    // Wraps a caller-owned row-major nPoints x nPoints matrix of squared distances.
+    // Nothing is copied, so the buffer must outlive this object.
+    DistanceMatrix(const double* matrix, int nPoints);
 	~DistanceMatrix();
-    double getDistance(int i, int j);
+
+    inline double getDistance(int i, int j){
+        if(storageType == STORAGE_DOUBLE){
+            return i > j ? adj[i][j] : adj[j][i];
+        }
+        if(storageType == STORAGE_FLOAT){
+            return i > j ? adjSingle[i][j] : adjSingle[j][i];
+        }
+        if(storageType == STORAGE_MAPPED){
+            return mapped[(size_t)i*rowStride + j];
+        }
+        return computeDistance(i, j);
+    }
+
+    // Row cache hints of STORAGE_MAPPED, no-ops for the other storages:
+    // useRow before reading getDistance(i, *) for many points, prefetchRow
+    // for a row that will be used soon.
+    inline void useRow(int i){
+        if(storageType == STORAGE_MAPPED) cacheRow(i, false);
+    }
+    inline void prefetchRow(int i){
+        if(storageType == STORAGE_MAPPED) cacheRow(i, true);
+    }
+    DistanceCacheStats getCacheStats();
+
     void setDistance(int i, int j, double d);
+    // Row i of the lower triangle: entry j is the distance of i and j, for
+    // j <= i. Points into the matrix with double or mapped storage (where it
+    // counts as useRow); otherwise the row is written into buffer, which must
+    // hold i+1 values, and buffer is returned.
+    const double* getRow(int i, double* buffer);
+    // Appends count points given by row-major coordinates, computing only
+    // their rows. Returns false, changing nothing, if the matrix was not
+    // built from coordinates or is mapped.
+    bool addPoints(const double* coordinates, int count);
+    // Deletes point i by moving the last point into index i, in O(n).
+    // Returns false for a wrapped caller matrix, a mapped one, or for
+    // on-the-fly storage without coordinates.
+    bool removePoint(int i);
+    // Gives point i new coordinates and recomputes its row and column, in
+    // O(nd). Returns false if the matrix was not built from coordinates or
+    // is mapped.
+    bool updatePoint(int i, const double* coordinates);
+    int getSize();
+    // Whether the matrix keeps the coordinates of its points, which adding
+    // and updating points require.
+    bool hasCoordinates();
+    // Whether addPoints, removePoint and updatePoint can succeed: built from
+    // coordinates and not mapped.
+    bool editable();
+    // The centred coordinates, row-major, when hasCoordinates().
+    const double* getCoordinates();
+    int getDimensions();
+    // Memory held by the matrix: the distances (for STORAGE_MAPPED, its row
+    // cache), the row pointers and the centred coordinates.
+    size_t getBytes();
+    DistanceStorage getStorage();
+    MemoryBacking getBacking();
+    // Sorts, for every entity, the other entities by increasing distance;
+    // keeps only the nNeighbours nearest ones when nNeighbours > 0.
+    void rankEntities(vector< vector<Pair> >& rankedEntities, int nNeighbours = 0);
 };
 #endif
 
@@ -0,0 +1,232 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "ElitePool.h"
+#include <float.h>
+#include <climits>
+#include <algorithm>
+
+using namespace std;
+
+// Swaps sampled at every step of a walk: up to this many misplaced points,
+// each tried with up to this many partners.
+static const int RELINK_SAMPLE = 32;
+
+// Change of the objective if points i and j exchange their clusters.
+static inline double swapDelta(Solution& solution, int i, int j){
+	int a = solution.assignment[i];
+	int b = solution.assignment[j];
+	double d = solution.distances->getDistance(i, j);
+	return (solution.sc[j][a] - solution.sc[i][a] - d) / solution.clusterSizes[a] +
+	       (solution.sc[i][b] - solution.sc[j][b] - d) / solution.clusterSizes[b];
+}
+
+ElitePool::ElitePool(int _capacity, int _nDataPoints, int _nClusters){
+	capacity = _capacity;
+	nDataPoints = _nDataPoints;
+	nClusters = _nClusters;
+	minDistance = max(2, nDataPoints / 100);
+	overlap.resize(nClusters * nClusters);
+	match.resize(nClusters);
+}
+
+int ElitePool::size(){
+	return elites.size();
+}
+
+double ElitePool::getValue(int index){
+	return elites[index].value;
+}
+
+const vector<int>& ElitePool::getAssignment(int index){
+	return elites[index].assignment;
+}
+
+// Hungarian algorithm on the cost -overlap, rows being the clusters of A and
+// columns those of B, with potentials u and v (1-based, column 0 is a sentinel).
+int ElitePool::matchClusters(const int* assignmentA, const int* assignmentB){
+	int k = nClusters;
+	fill(overlap.begin(), overlap.end(), 0);
+	for(int p=0; p<nDataPoints; p++){
+		overlap[assignmentA[p]*k + assignmentB[p]]++;
+	}
+
+	vector<int> u(k+1, 0), v(k+1, 0), row(k+1, 0), way(k+1, 0), minv(k+1);
+	vector<char> used(k+1);
+	for(int i=1; i<=k; i++){
+		row[0] = i;
+		int j0 = 0;
+		fill(minv.begin(), minv.end(), INT_MAX);
+		fill(used.begin(), used.end(), 0);
+		do{
+			used[j0] = 1;
+			int i0 = row[j0], delta = INT_MAX, j1 = 0;
+			for(int j=1; j<=k; j++){
+				if(used[j]) continue;
+				int cur = -overlap[(i0-1)*k + j-1] - u[i0] - v[j];
+				if(cur < minv[j]){
+					minv[j] = cur;
+					way[j] = j0;
+				}
+				if(minv[j] < delta){
+					delta = minv[j];
+					j1 = j;
+				}
+			}
+			for(int j=0; j<=k; j++){
+				if(used[j]){
+					u[row[j]] += delta;
+					v[j] -= delta;
+				}else{
+					minv[j] -= delta;
+				}
+			}
+			j0 = j1;
+		}while(row[j0] != 0);
+		do{
+			int j1 = way[j0];
+			row[j0] = row[j1];
+			j0 = j1;
+		}while(j0 != 0);
+	}
+
+	int matched = 0;
+	for(int j=1; j<=k; j++){
+		match[j-1] = row[j]-1;
+		matched += overlap[(row[j]-1)*k + j-1];
+	}
+	return matched;
+}
+
+int ElitePool::distance(const int* assignmentA, const int* assignmentB){
+	return nDataPoints - matchClusters(assignmentA, assignmentB);
+}
+
+bool ElitePool::insert(const Solution& solution){
+	if(capacity <= 0) return false;
+
+	int nearest = INT_MAX;
+	int closestWorse = -1, closestWorseDistance = INT_MAX;
+	bool improvesBest = true;
+	for(size_t e=0; e<elites.size(); e++){
+		if(elites[e].hash == solution.hash) return false;
+		int d = distance(solution.assignment, &elites[e].assignment[0]);
+		if(d == 0) return false;
+		nearest = min(nearest, d);
+		if(elites[e].value <= solution.solutionValue){
+			improvesBest = false;
+		}else if(d < closestWorseDistance){
+			closestWorse = e;
+			closestWorseDistance = d;
+		}
+	}
+	if(!improvesBest && nearest < minDistance) return false;
+
+	Elite* slot;
+	if((int)elites.size() < capacity){
+		elites.push_back(Elite());
+		slot = &elites.back();
+	}else if(closestWorse >= 0){
+		slot = &elites[closestWorse];
+	}else{
+		return false;
+	}
+	slot->assignment.assign(solution.assignment, solution.assignment + nDataPoints);
+	slot->value = solution.solutionValue;
+	slot->hash = solution.hash;
+	return true;
+}
+
+int ElitePool::relink(Solution& solution, int index, LocalSearch& localSearch, Random* random){
+	const int* guide = &elites[index].assignment[0];
+	matchClusters(solution.assignment, guide);
+
+	// Points outside their target cluster, listed by current cluster, and
+	// the index of each in its list
+	vector<int> target(nDataPoints), slot(nDataPoints);
+	vector< vector<int> > misplaced(nClusters);
+	int remaining = 0;
+	for(int p=0; p<nDataPoints; p++){
+		target[p] = match[guide[p]];
+		int c = solution.assignment[p];
+		if(target[p] != c){
+			slot[p] = misplaced[c].size();
+			misplaced[c].push_back(p);
+			remaining++;
+		}
+	}
+
+	vector< pair<int, int> > walk;
+	double bestValue = DBL_MAX;
+	int bestStep = 0;
+	while(remaining > 0){
+		// Cheapest swap of a misplaced point i with a misplaced point j of the
+		// target cluster of i; get_rand draws from [1, size]
+		int bestI = -1, bestJ = -1;
+		double bestDelta = DBL_MAX;
+		int samples = min(remaining, RELINK_SAMPLE);
+		for(int s=0; s<samples; s++){
+			int r = remaining <= RELINK_SAMPLE ? s : random->get_rand(remaining) - 1;
+			int a = 0;
+			while(r >= (int)misplaced[a].size()){
+				r -= misplaced[a].size();
+				a++;
+			}
+			int i = misplaced[a][r];
+			const vector<int>& partners = misplaced[target[i]];
+			int count = partners.size();
+			int start = count > RELINK_SAMPLE ? random->get_rand(count) - 1 : 0;
+			for(int t=0; t<min(count, RELINK_SAMPLE); t++){
+				int j = partners[(start + t) % count];
+				double delta = swapDelta(solution, i, j);
+				if(delta < bestDelta){
+					bestDelta = delta;
+					bestI = i;
+					bestJ = j;
+				}
+			}
+		}
+		// Only left when the matched clusters of the two solutions differ in size
+		if(bestI < 0) break;
+
+		int a = solution.assignment[bestI];
+		int b = solution.assignment[bestJ];
+		localSearch.swap(solution, bestI, bestJ, bestDelta);
+		walk.push_back(make_pair(bestI, bestJ));
+
+		// bestI reached its target b; bestJ leaves b and may be at home in a
+		int removed[2] = {bestI, bestJ};
+		int from[2] = {a, b};
+		for(int t=0; t<2; t++){
+			vector<int>& list = misplaced[from[t]];
+			int last = list.back();
+			list[slot[removed[t]]] = last;
+			slot[last] = slot[removed[t]];
+			list.pop_back();
+			remaining--;
+		}
+		if(target[bestJ] != a){
+			slot[bestJ] = misplaced[a].size();
+			misplaced[a].push_back(bestJ);
+			remaining++;
+		}
+
+		if(remaining > 0 && solution.solutionValue < bestValue){
+			bestValue = solution.solutionValue;
+			bestStep = walk.size();
+		}
+	}
+
+	// Undo the swaps made after the best intermediate solution
+	for(int t=(int)walk.size()-1; t>=bestStep; t--){
+		int i = walk[t].first, j = walk[t].second;
+		localSearch.swap(solution, i, j, swapDelta(solution, i, j));
+	}
+	return bestStep;
+}
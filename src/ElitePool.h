@@ -0,0 +1,67 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef ELITEPOOL_H_
+#define ELITEPOOL_H_
+
+#include <vector>
+#include "Solution.h"
+#include "LocalSearch.h"
+#include "Random.h"
+
+using namespace std;
+
+// Pool of up to capacity local optima kept for their quality and diversity.
+// Solutions are compared with the partition distance: the least number of
+// points that must change cluster to turn one partition into the other,
+// whatever the labels. It is n minus the heaviest matching of the k x k
+// overlap matrix, found with the Hungarian algorithm in O(n + k^3). Only the
+// assignments are stored, not sc.
+class ElitePool {
+public:
+	ElitePool(int _capacity, int _nDataPoints, int _nClusters);
+
+	// Offers a local optimum. Copies of an elite are rejected, and so are
+	// solutions that do not improve on the best elite and lie within
+	// minDistance of some elite. Once the pool is full the newcomer must also
+	// beat the worst elite, and replaces the closest elite worse than itself.
+	bool insert(const Solution& solution);
+	int size();
+	double getValue(int index);
+	const vector<int>& getAssignment(int index);
+	int distance(const int* assignmentA, const int* assignmentB);
+
+	// Walks from solution towards the elite by balance-preserving swaps, each
+	// putting at least one more point into its cluster of the elite (labels
+	// matched as for the distance). Every step takes the cheapest of a sample
+	// of such swaps and updates sc incrementally. solution is left at the
+	// best point strictly between the two ends, or unchanged if the walk had
+	// none. Returns the number of swaps kept.
+	int relink(Solution& solution, int index, LocalSearch& localSearch, Random* random);
+
+private:
+	struct Elite {
+		vector<int> assignment;
+		double value;
+		uint64_t hash;
+	};
+
+	int capacity;
+	int nDataPoints;
+	int nClusters;
+	int minDistance;
+	vector<Elite> elites;
+
+	vector<int> overlap;    // k x k, points in cluster a of one solution and b of the other
+	vector<int> match;      // cluster of the first solution matched to each cluster of the second
+
+	// Fills match for the two assignments and returns the matched overlap.
+	int matchClusters(const int* assignmentA, const int* assignmentB);
+};
+#endif /* ELITEPOOL_H_ */
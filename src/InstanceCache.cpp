@@ -0,0 +1,103 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "InstanceCache.h"
+#include "CSVReader.h"
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+Instance::Instance(const string& _path){
+	path = _path;
+	ifstream file(path.c_str());
+	if(!file.good()){
+		throw runtime_error("cannot read instance " + path);
+	}
+	Reader reader;
+	dataset = reader.readInstance(path);
+	if(dataset.empty()){
+		throw runtime_error("empty instance " + path);
+	}
+	distances = new DistanceMatrix(&dataset);
+
+	size_t n = dataset.size();
+	size_t d = dataset[0].getDimensions();
+	bytes = n*d*sizeof(double) + distances->getBytes();   // dataset and matrix
+}
+
+Instance::~Instance(){
+	delete distances;
+}
+
+InstanceCache::InstanceCache(size_t _maxBytes){
+	maxBytes = _maxBytes;
+	bytes = 0;
+	hits = 0;
+	misses = 0;
+}
+
+shared_ptr<Instance> InstanceCache::get(const string& path){
+	{
+		lock_guard<mutex> guard(lock);
+		map<string, Entries::iterator>::iterator it = index.find(path);
+		if(it != index.end()){
+			hits++;
+			entries.splice(entries.begin(), entries, it->second);
+			return *it->second;
+		}
+		misses++;
+	}
+
+	// Loading is O(n^2), so it runs outside the lock. Two jobs missing on the
+	// same path at once both load it and the second insertion is dropped.
+	shared_ptr<Instance> instance = make_shared<Instance>(path);
+
+	lock_guard<mutex> guard(lock);
+	map<string, Entries::iterator>::iterator it = index.find(path);
+	if(it != index.end()){
+		return *it->second;
+	}
+	entries.push_front(instance);
+	index[path] = entries.begin();
+	bytes += instance->bytes;
+	evict();
+	return instance;
+}
+
+// Drops least recently used instances until the cap is met, always keeping
+// the most recent one.
+void InstanceCache::evict(){
+	while(bytes > maxBytes && entries.size() > 1){
+		shared_ptr<Instance> last = entries.back();
+		bytes -= last->bytes;
+		index.erase(last->path);
+		entries.pop_back();
+	}
+}
+
+size_t InstanceCache::getBytes(){
+	lock_guard<mutex> guard(lock);
+	return bytes;
+}
+
+int InstanceCache::getSize(){
+	lock_guard<mutex> guard(lock);
+	return entries.size();
+}
+
+long InstanceCache::getHits(){
+	lock_guard<mutex> guard(lock);
+	return hits;
+}
+
+long InstanceCache::getMisses(){
+	lock_guard<mutex> guard(lock);
+	return misses;
+}
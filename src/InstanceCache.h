@@ -0,0 +1,65 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef INSTANCECACHE_H_
+#define INSTANCECACHE_H_
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "Point.h"
+#include "DistanceMatrix.h"
+#include "Pair.h"
+
+using namespace std;
+
+// A dataset loaded once together with everything that only depends on it.
+struct Instance {
+	string path;
+	vector<Point> dataset;
+	DistanceMatrix* distances;
+	vector< vector<Pair> > rankedEntities;  // left empty; the multilevel mode ranks its own levels
+	size_t bytes;
+
+	Instance(const string& _path);
+	~Instance();
+};
+
+// LRU cache of loaded instances bounded by an estimate of their memory use.
+// Evicted instances stay alive while a running job still holds them.
+class InstanceCache {
+public:
+	InstanceCache(size_t _maxBytes);
+
+	// Returns the cached instance for path, loading it on a miss. Throws
+	// runtime_error if the file cannot be read.
+	shared_ptr<Instance> get(const string& path);
+
+	size_t getBytes();
+	int getSize();
+	long getHits();
+	long getMisses();
+
+private:
+	typedef list< shared_ptr<Instance> > Entries;
+
+	size_t maxBytes;
+	size_t bytes;
+	long hits;
+	long misses;
+	Entries entries;              // most recently used first
+	map<string, Entries::iterator> index;
+	mutex lock;
+
+	void evict();
+};
+#endif /* INSTANCECACHE_H_ */
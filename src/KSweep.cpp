@@ -0,0 +1,238 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "KSweep.h"
+#include <thread>
+#include <algorithm>
+#include <iomanip>
+#include <float.h>
+
+using namespace std;
+
+// Share of the time limit a k runs before its solution seeds the next k.
+static const double SEED_SHARE = 0.2;
+
+KSweep::KSweep(DistanceMatrix* _distances, vector< vector<Pair> >* _rankedEntities, const SolverParams& _params){
+	distances = _distances;
+	rankedEntities = _rankedEntities;
+	params = _params;
+}
+
+KSweep::~KSweep(){
+	for(int i=0; i<(signed)slots.size(); i++){
+		delete slots[i].solution;
+		delete slots[i].seed;
+	}
+}
+
+void KSweep::run(int anchor, int last, Random& random){
+	int first = min(anchor, last);
+	int count = abs(last - anchor) + 1;
+	int anchorIndex = anchor - first;
+	int n = distances->getSize();
+
+	// Streams are split outwards from the anchor, so a sweep is reproduced
+	// by the same seed whatever the order the threads run in
+	slots.clear();
+	rows.assign(count, Row());
+	vector<Random> streams;
+	for(int i=0; i<count; i++){
+		streams.push_back(random.split());
+	}
+	for(int i=0; i<count; i++){
+		int step = abs(i - anchorIndex);
+		Slot slot = {streams[step], new Solution(first + i, n, distances), NULL, -1, false};
+		if(i != anchorIndex) slot.from = i < anchorIndex ? i + 1 : i - 1;
+		slot.seeds = i != (anchorIndex == 0 ? count - 1 : 0);
+		slots.push_back(slot);
+		rows[i].k = first + i;
+	}
+
+	vector<thread> workers;
+	for(int i=0; i<count; i++){
+		workers.push_back(thread(&KSweep::solve, this, i));
+	}
+	for(int i=0; i<count; i++){
+		workers[i].join();
+	}
+}
+
+void KSweep::solve(int index){
+	Slot& slot = slots[index];
+	Row& row = rows[index];
+	Solution& solution = *slot.solution;
+	SolverParams runParams = params;
+	runParams.nClusters = row.k;
+	runParams.verbose = false;
+	if(!runParams.wallClock) runParams.threadClock = true;
+	row.start = "cold";
+
+	if(slot.from >= 0){
+		unique_lock<mutex> guard(lock);
+		Slot& source = slots[slot.from];
+		published.wait(guard, [&source]{ return source.seed != NULL; });
+		guard.unlock();
+		if(row.k > source.seed->nClusters){
+			split(*source.seed, solution);
+			row.start = "split";
+		}else{
+			merge(*source.seed, solution);
+			row.start = "merge";
+		}
+		runParams.warmStart = true;
+		runParams.multilevel = false;
+	}
+
+	double seedTime = 0.0;
+	double seedValue = DBL_MAX;
+	row.iterations = 0;
+	if(slot.seeds){
+		SolverParams seedParams = runParams;
+		seedParams.maxTime = params.maxTime * SEED_SHARE;
+		row.iterations += Solver::run(seedParams, solution, distances, rankedEntities, &slot.random);
+		Solution* seed = new Solution(solution);
+		{
+			lock_guard<mutex> guard(lock);
+			slot.seed = seed;
+		}
+		published.notify_all();
+
+		seedTime = seedParams.maxTime;
+		seedValue = solution.solutionValue;
+		row.time = solution.time;
+		runParams.maxTime -= seedParams.maxTime;
+		runParams.warmStart = true;
+		runParams.multilevel = false;
+	}
+	row.iterations += Solver::run(runParams, solution, distances, rankedEntities, &slot.random);
+	if(solution.solutionValue < seedValue) row.time = seedTime + solution.time;
+	row.value = solution.solutionValue;
+}
+
+const vector<KSweep::Row>& KSweep::getRows(){
+	return rows;
+}
+
+const Solution& KSweep::getSolution(int i){
+	return *slots[i].solution;
+}
+
+void KSweep::print(ostream& out){
+	out << "     k        Objective      Drop       Time  Iterations  Start" << endl;
+	for(int i=0; i<(signed)rows.size(); i++){
+		out << setw(6) << rows[i].k;
+		out << setw(17) << setprecision(8) << scientific << rows[i].value;
+		if(i > 0 && rows[i-1].value > 0){
+			out << setw(9) << setprecision(2) << fixed << 100.0 * (rows[i-1].value - rows[i].value) / rows[i-1].value << "%";
+		}else{
+			out << setw(10) << "-";
+		}
+		out << setw(10) << setprecision(4) << fixed << rows[i].time << "s";
+		out << setw(12) << rows[i].iterations;
+		out << "  " << rows[i].start << endl;
+	}
+}
+
+void KSweep::split(const Solution& from, Solution& to){
+	int n = from.nDataPoints;
+	int k = from.nClusters;
+	vector<double> pairSum(k, 0.0);
+	for(int i=0; i<n; i++){
+		pairSum[from.assignment[i]] += from.sc[i][from.assignment[i]] / 2.0;
+	}
+	int costliest = 0;
+	for(int c=1; c<k; c++){
+		if(pairSum[c] / from.clusterSizes[c] > pairSum[costliest] / from.clusterSizes[costliest]) costliest = c;
+	}
+
+	// Two far apart members: the one farthest from the centroid, whose
+	// squared distance is sc/|C| - W/|C|^2, then the one farthest from it
+	const vector<int>& cluster = from.members[costliest];
+	double size = from.clusterSizes[costliest];
+	int p = cluster[0];
+	double farthest = -DBL_MAX;
+	for(int m=0; m<(signed)cluster.size(); m++){
+		double dist = from.sc[cluster[m]][costliest] / size - pairSum[costliest] / (size * size);
+		if(dist > farthest){
+			farthest = dist;
+			p = cluster[m];
+		}
+	}
+	int q = p;
+	farthest = -DBL_MAX;
+	for(int m=0; m<(signed)cluster.size(); m++){
+		double dist = from.distances->getDistance(p, cluster[m]);
+		if(dist > farthest){
+			farthest = dist;
+			q = cluster[m];
+		}
+	}
+
+	// The half of the cluster nearer to q, relative to p, becomes cluster k
+	vector<Pair> order;
+	for(int m=0; m<(signed)cluster.size(); m++){
+		order.push_back(Pair(cluster[m], from.distances->getDistance(q, cluster[m]) - from.distances->getDistance(p, cluster[m])));
+	}
+	sort(order.begin(), order.end());
+	vector<int> labels(from.assignment, from.assignment + n);
+	for(int m=0; m<(signed)order.size()/2; m++){
+		labels[order[m].getId()] = k;
+	}
+	finish(to, labels);
+}
+
+void KSweep::merge(const Solution& from, Solution& to){
+	int n = from.nDataPoints;
+	int k = from.nClusters;
+	// cross[a*k+b] sums the distances between the points of a and of b
+	vector<double> cross(k * k, 0.0);
+	for(int i=0; i<n; i++){
+		double* row = &cross[from.assignment[i] * k];
+		for(int b=0; b<k; b++){
+			row[b] += from.sc[i][b];
+		}
+	}
+
+	int mergeA = 0, mergeB = 1;
+	double cheapest = DBL_MAX;
+	for(int a=0; a<k; a++){
+		double sizeA = from.clusterSizes[a];
+		double costA = sizeA > 0 ? cross[a*k+a] / 2.0 / sizeA : 0.0;
+		for(int b=a+1; b<k; b++){
+			double sizeB = from.clusterSizes[b];
+			double costB = sizeB > 0 ? cross[b*k+b] / 2.0 / sizeB : 0.0;
+			double joint = (cross[a*k+a] / 2.0 + cross[b*k+b] / 2.0 + cross[a*k+b]) / (sizeA + sizeB);
+			if(joint - costA - costB < cheapest){
+				cheapest = joint - costA - costB;
+				mergeA = a;
+				mergeB = b;
+			}
+		}
+	}
+
+	// b joins a, and the last label takes the place of b
+	vector<int> labels(from.assignment, from.assignment + n);
+	for(int i=0; i<n; i++){
+		if(labels[i] == mergeB) labels[i] = mergeA;
+		else if(labels[i] == k - 1) labels[i] = mergeB;
+	}
+	finish(to, labels);
+}
+
+void KSweep::finish(Solution& to, const vector<int>& labels){
+	for(int c=0; c<to.nClusters; c++){
+		to.clusterSizes[c] = 0;
+	}
+	for(int i=0; i<to.nDataPoints; i++){
+		to.assignment[i] = labels[i];
+		to.clusterSizes[labels[i]]++;
+	}
+	to.initializeSc();
+	to.rebalance();
+}
@@ -0,0 +1,80 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef KSWEEP_H_
+#define KSWEEP_H_
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <iostream>
+#include "DistanceMatrix.h"
+#include "Pair.h"
+#include "Solution.h"
+#include "Solver.h"
+#include "Random.h"
+
+using namespace std;
+
+// Solves every number of clusters between two values in one process, on a
+// single shared distance matrix. The first k of the range (the anchor) starts
+// from scratch; every other k starts from the solution of its neighbour
+// towards the anchor, taken once that neighbour has spent SEED_SHARE of its
+// time: one more cluster is made by halving the costliest cluster, one less
+// by merging the pair of clusters whose union costs least, and the sizes are
+// then rebalanced. Every k runs on its own thread with its own stream of the
+// random generator and its own CPU clock, so each gets params.maxTime of CPU
+// whatever the number of cores.
+class KSweep {
+public:
+	struct Row {
+		int k;
+		double value;
+		double time;          // CPU seconds to the best solution, seeding phase included
+		int iterations;
+		const char* start;    // "cold", "split" or "merge"
+	};
+
+	KSweep(DistanceMatrix* _distances, vector< vector<Pair> >* _rankedEntities, const SolverParams& _params);
+	~KSweep();
+
+	// Solves k = anchor..last (either direction) with streams split from random.
+	void run(int anchor, int last, Random& random);
+	const vector<Row>& getRows();
+	// Final solution for the i-th k of the sweep, in the order of getRows.
+	const Solution& getSolution(int i);
+	// Objective against k, in increasing k, with the relative drop from the
+	// previous k.
+	void print(ostream& out);
+
+	static void split(const Solution& from, Solution& to);
+	static void merge(const Solution& from, Solution& to);
+
+private:
+	struct Slot {
+		Random random;
+		Solution* solution;
+		Solution* seed;       // copy published for the next k, NULL until ready
+		int from;             // slot this one is seeded from, -1 for the anchor
+		bool seeds;           // some slot is seeded from this one
+	};
+
+	DistanceMatrix* distances;
+	vector< vector<Pair> >* rankedEntities;
+	SolverParams params;
+	vector<Slot> slots;
+	vector<Row> rows;
+	mutex lock;
+	condition_variable published;
+
+	void solve(int index);
+	// Fills assignment, sizes and sc of to from labels and rebalances it.
+	static void finish(Solution& to, const vector<int>& labels);
+};
+#endif /* KSWEEP_H_ */
@@ -16,12 +16,25 @@
 #include <iomanip>
 #include <fstream>
 #include "Random.h"
+#include "Planner.h"
 #include <sstream>
 #include "Pair.h"
+#include "Solver.h"
+#include "KSweep.h"
 #include <algorithm>
 
 using namespace std;
 
+// Row cache activity of the mapped storage over the whole process.
+static void printCacheStats(DistanceMatrix& distances){
+	if(distances.getStorage() != STORAGE_MAPPED) return;
+	DistanceCacheStats stats = distances.getCacheStats();
+	cout << "Distance cache: " << stats.rowReads << " row reads, " << setprecision(1) << fixed
+			<< (stats.rowReads > 0 ? 100.0 * stats.rowHits / stats.rowReads : 0.0) << "% hits, "
+			<< stats.prefetches << " prefetched, " << stats.evictions << " evicted, "
+			<< stats.bytesRead / 1048576.0 << " MB read from disk" << endl;
+}
+
 int main(int argc, char** argv) {
 	Reader reader;
 	vector<Point> dataset;
@@ -38,15 +51,18 @@ int main(int argc, char** argv) {
 	string path_output;
 	string path_output_assignment;
 	string init_solutions_dir = ""; // New parameter for initial solutions
+	string initial_assignment;      // initial=<file>, the same start for every run
+	SolverParams params;            // name=value options after the positional arguments
 
 	///////////////////////////////////////
 
 	if(argc < 8){
 		cout << "ARGUMENT(S) MISSING!!" << endl << "Usage: " << argv[0];
 		cout << " <path/instance.csv> <k=number of clusters> <cpu time limit>";
-		cout << " <number of runs> <seed> <path/output file> <path/assignment file> [initial_solutions_dir]" << endl;
+		cout << " <number of runs> <seed> <path/output file> <path/assignment file> [initial_solutions_dir] [name=value ...]" << endl;
 		return EXIT_FAILURE;
 	}else{
+		 params.verbose = true;
 		 path_instance = argv[1];
 		 n_clusters = atoi(argv[2]);
 		 max_time = atof(argv[3]);
@@ -55,10 +71,20 @@ int main(int argc, char** argv) {
 		 path_output = argv[6];
 		 path_output_assignment = argv[7];
 		 
-		 // Check if initial solutions directory is provided
-		 if(argc >= 9){
-			init_solutions_dir = argv[8];
-			cout << "Using initial solutions from: " << init_solutions_dir << endl;
+		 // Check if initial solutions directory and options are provided
+		 for(int a=8; a<argc; a++){
+			string arg = argv[a];
+			if(arg.find('=') != string::npos){
+				if(arg.compare(0, 8, "initial=") == 0){
+					initial_assignment = arg.substr(8);
+				}else if(!params.parse(arg)){
+					cout << "INVALID OPTION: " << arg << endl;
+					return EXIT_FAILURE;
+				}
+			}else{
+				init_solutions_dir = arg;
+				cout << "Using initial solutions from: " << init_solutions_dir << endl;
+			}
 		 }
 	}
 
@@ -109,37 +135,98 @@ int main(int argc, char** argv) {
 	results_assignment_file.open(str_assignment.str().c_str(), ofstream::app);
 
 
-    int kMin = 2;
 	int averageVnsIteration = 0;
 	dataset = reader.readInstance(path_instance);
-	DistanceMatrix distances(&dataset);
+	setHugePagePolicy(params.hugePages, params.prefault);
+	setCpuLevel(params.cpuAuto ? detectCpuLevel() : params.cpuLevel);
+	setMappedStorage(params.spillDirectory, (size_t)params.cacheSize << 20);
+	DistanceStorage storage = params.storage;
+	if(params.storageAuto){
+		int nDimensions = dataset.empty() ? 0 : dataset[0].getDimensions();
+		Planner planner(dataset.size(), nDimensions, n_clusters, params.multilevel);
+		storage = planner.choose((size_t)params.memoryCap << 20, &cout);
+		if(storage == STORAGE_MAPPED) setMappedStorage(params.spillDirectory, planner.getCacheBytes());
+	}
+	DistanceMatrix distances(&dataset, params.threads, storage);
 	Solution bestSolution(n_clusters, dataset.size(), &distances);
 
-	vector< vector<Pair> > rankedEntities(dataset.size());
-	for(unsigned int o=0; o<dataset.size(); o++){
-		for(unsigned int m=0; m<dataset.size(); m++){
-			if(o!=m){
-				Pair pair(m, distances.getDistance(o,m));
-				rankedEntities[o].push_back(pair);
-			}
-		}
-		sort(rankedEntities[o].begin(), rankedEntities[o].end());
-	}
+	// Only the multilevel mode needs neighbour lists, and it builds the
+	// short ones it uses itself
+	vector< vector<Pair> > rankedEntities;
 
-	int kMax = dataset.size()/2;
-	int kStep = (int)kMax/20;
+	int kMax = params.kMax > 0 ? params.kMax : dataset.size()/2;
+	int kStep = params.kStep > 0 ? params.kStep : (int)kMax/20;
+	params.nClusters = n_clusters;
+	params.maxTime = max_time;
+	params.kMax = kMax;
+	params.kStep = kStep;
 
 	cout << "============================================================================================================" << endl;
 	cout << "Instance: " << path_instance << endl;
 	cout << "Clusters: " << n_clusters << endl;
 	cout << "Kmax: " << kMax << endl;
 	cout << "KStep: " << kStep<< endl;
+	cout << "CPU: " << cpuLevelName(getCpuLevel()) << " kernels, host supports " << cpuLevelName(detectCpuLevel()) << endl;
+	cout << "Memory: " << storageName(distances.getStorage()) << " distances on " << backingName(distances.getBacking()) << ", sc on " << backingName(bestSolution.scStorage.backing) << endl;
+
+	if(params.sweepTo > 0){
+		if(params.sweepTo < 2 || params.sweepTo > (signed)dataset.size()){
+			cout << "INVALID SWEEP RANGE: " << n_clusters << " to " << params.sweepTo << endl;
+			return EXIT_FAILURE;
+		}
+		// One line per k in increasing k, with the best and mean over the runs
+		int first = min(n_clusters, params.sweepTo);
+		int count = abs(params.sweepTo - n_clusters) + 1;
+		vector<double> sweepBest(count, DBL_MAX), sweepMean(count, 0.0);
+		vector<double> sweepBestTime(count, 0.0), sweepTimeMean(count, 0.0);
+		vector< vector<int> > sweepAssignment(count);
+		for(int j=0; j<n_runs; j++){
+			cout << "------------------------------------- Execution " <<  j+1 << " -----------------------------------------" << endl;
+			cout << "Seed = " << seed << endl;
+			cout << "Sweep: k = " << n_clusters << " to " << params.sweepTo << ", maxTime = " << setprecision(4) << fixed << max_time << " per k" << endl;
+			Random random(seed, params.rngEngine);
+			params.seed = seed;
+			KSweep sweep(&distances, &rankedEntities, params);
+			sweep.run(n_clusters, params.sweepTo, random);
+			sweep.print(cout);
+			const vector<KSweep::Row>& rows = sweep.getRows();
+			for(int i=0; i<count; i++){
+				if(rows[i].value < sweepBest[i]){
+					const Solution& solution = sweep.getSolution(i);
+					sweepBest[i] = rows[i].value;
+					sweepBestTime[i] = rows[i].time;
+					sweepAssignment[i].assign(solution.assignment, solution.assignment + solution.nDataPoints);
+				}
+				sweepMean[i] += rows[i].value;
+				sweepTimeMean[i] += rows[i].time;
+			}
+			seed += 1;
+		}
+		for(int i=0; i<count; i++){
+			results_stats_file << path_instance << "," << first + i;
+			results_stats_file << "," << setprecision(8) << scientific << sweepBest[i];
+			results_stats_file << "," << setprecision(8) << scientific << sweepMean[i]/n_runs;
+			results_stats_file << "," << setprecision(4) << fixed << sweepBestTime[i];
+			results_stats_file << "," << setprecision(4) << fixed << sweepTimeMean[i]/n_runs << endl;
+
+			results_assignment_file << path_instance;
+			for(int p=0; p<(signed)sweepAssignment[i].size(); p++){
+				results_assignment_file << ',' << sweepAssignment[i][p];
+			}
+			results_assignment_file << endl;
+		}
+		printCacheStats(distances);
+		cout <<"**************************************************************************************"<<endl;
+		results_stats_file.close();
+		results_assignment_file.close();
+		return 0;
+	}
 
 	double mean = 0.0;
 	double timeMean = 0.0;
 	bestSolutionValue = DBL_MAX;
 	for(int j=0; j<n_runs; j++){
-		Random random(seed);
+		Random random(seed, params.rngEngine);
 		Vns vns(&dataset, &distances, n_clusters, &random, &rankedEntities);
 
 		cout << "------------------------------------- Execution " <<  j+1 << " -----------------------------------------" << endl;
@@ -165,15 +252,17 @@ int main(int argc, char** argv) {
 			init_file << init_solutions_dir << "/" << dataset_name << "-init" << (j+1) << ".bin";
 			
 			cout << "Loading initial solution from: " << init_file.str() << endl;
-			vns.loadInitialSolution(solution, init_file.str());
+			params.warmStart = vns.loadInitialSolution(solution, init_file.str());
+		} else if(!initial_assignment.empty()){
+			cout << "Loading initial solution from: " << initial_assignment << endl;
+			params.warmStart = vns.loadInitialSolution(solution, initial_assignment);
 		} else {
 			// Generate a new random initial solution
 			//vns.initialSolution(solution);
 		}
 		
-		stringstream ss;
-
-		int nIteration = vns.execute(solution, max_time, kMin, kStep, kMax, ss.str());
+		params.seed = seed;
+		int nIteration = Solver::run(params, solution, &distances, &rankedEntities, &random);
 
 		if(solution.solutionValue < bestSolutionValue){
 			bestSolution.copy(solution);
@@ -193,7 +282,9 @@ int main(int argc, char** argv) {
 	cout <<endl<<"**************************************************************************************"<<endl<<endl;
 	cout << "Best Objective Function value found: " << setprecision(8) << scientific << bestSolutionValue << " in " << setprecision(4) << fixed<< bestTime << " seconds"<< endl;
 	cout << "Average Objective Function value: " << setprecision(8)<<scientific<< mean/n_runs << endl;
-	cout << "Average Time value: "<< setprecision(4) <<fixed<< timeMean/n_runs <<"s"<< endl << endl;
+	cout << "Average Time value: "<< setprecision(4) <<fixed<< timeMean/n_runs <<"s"<< endl;
+	printCacheStats(distances);
+	cout << endl;
 
 	results_stats_file << path_instance;
 	results_stats_file << "," << setprecision(8) << scientific << bestSolutionValue;
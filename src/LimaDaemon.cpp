@@ -0,0 +1,331 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//
+//               Long-lived solver process. Jobs arrive as text lines on
+//               stdin or on a Unix domain socket:
+//
+//                 solve <id> <path/instance.csv> [name=value ...]
+//                 cancel <id>
+//                 stats
+//                 quit
+//
+//               and are answered with "accepted", "progress", "result",
+//               "error" and "stats" lines. Loaded instances, their distance
+//               matrices and ranked entities are kept in an LRU cache.
+//============================================================================
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "InstanceCache.h"
+#include "Solver.h"
+
+using namespace std;
+
+// Bounds the number of jobs solving at the same time.
+class JobSlots {
+public:
+	JobSlots(int _free) : free(_free) {}
+	void acquire(){
+		unique_lock<mutex> guard(lock);
+		released.wait(guard, [this]() { return free > 0; });
+		free--;
+	}
+	void release(){
+		lock_guard<mutex> guard(lock);
+		free++;
+		released.notify_one();
+	}
+private:
+	int free;
+	mutex lock;
+	condition_variable released;
+};
+
+// One client connection. Job threads write to it concurrently.
+class Session {
+public:
+	Session(int _in, int _out) : in(_in), out(_out), running(0) {}
+
+	void send(const string& line){
+		lock_guard<mutex> guard(writeLock);
+		string data = line + "\n";
+		size_t written = 0;
+		while(written < data.size()){
+			ssize_t w = write(out, data.data() + written, data.size() - written);
+			if(w < 0){
+				if(errno == EINTR) continue;
+				return; // client went away, drop the output
+			}
+			written += w;
+		}
+	}
+
+	bool readLine(string& line){
+		size_t pos;
+		while((pos = buffer.find('\n')) == string::npos){
+			char chunk[4096];
+			ssize_t r = read(in, chunk, sizeof(chunk));
+			if(r < 0 && errno == EINTR) continue;
+			if(r <= 0){
+				if(buffer.empty()) return false;
+				line.swap(buffer);
+				buffer.clear();
+				return true;
+			}
+			buffer.append(chunk, r);
+		}
+		line = buffer.substr(0, pos);
+		buffer.erase(0, pos + 1);
+		if(!line.empty() && line[line.size()-1] == '\r') line.erase(line.size()-1);
+		return true;
+	}
+
+	shared_ptr< atomic<bool> > startJob(const string& id){
+		lock_guard<mutex> guard(jobsLock);
+		if(cancelFlags.count(id)) return shared_ptr< atomic<bool> >();
+		shared_ptr< atomic<bool> > flag = make_shared< atomic<bool> >(false);
+		cancelFlags[id] = flag;
+		running++;
+		return flag;
+	}
+
+	void finishJob(const string& id){
+		lock_guard<mutex> guard(jobsLock);
+		cancelFlags.erase(id);
+		running--;
+		finished.notify_all();
+	}
+
+	bool cancel(const string& id){
+		lock_guard<mutex> guard(jobsLock);
+		map<string, shared_ptr< atomic<bool> > >::iterator it = cancelFlags.find(id);
+		if(it == cancelFlags.end()) return false;
+		*it->second = true;
+		return true;
+	}
+
+	void cancelAll(){
+		lock_guard<mutex> guard(jobsLock);
+		for(map<string, shared_ptr< atomic<bool> > >::iterator it = cancelFlags.begin(); it != cancelFlags.end(); ++it){
+			*it->second = true;
+		}
+	}
+
+	void waitJobs(){
+		unique_lock<mutex> guard(jobsLock);
+		finished.wait(guard, [this]() { return running == 0; });
+	}
+
+	int getRunning(){
+		lock_guard<mutex> guard(jobsLock);
+		return running;
+	}
+
+private:
+	int in;
+	int out;
+	string buffer;
+	mutex writeLock;
+	mutex jobsLock;
+	condition_variable finished;
+	map<string, shared_ptr< atomic<bool> > > cancelFlags;
+	int running;
+};
+
+static InstanceCache* cache;
+static JobSlots* slots;
+
+static void runJob(shared_ptr<Session> session, string id, string path, SolverParams params, shared_ptr< atomic<bool> > cancelled){
+	slots->acquire();
+	try{
+		if(*cancelled){
+			throw runtime_error("cancelled before start");
+		}
+		shared_ptr<Instance> instance = cache->get(path);
+		Solver solver(instance->distances, &instance->rankedEntities);
+		solver.setProgressCallback([session, id](const SolverProgress& p) {
+			stringstream line;
+			line << "progress " << id << " " << p.iteration << " " << setprecision(8) << scientific << p.solutionValue;
+			line << " " << setprecision(4) << fixed << p.time << " " << p.k;
+			session->send(line.str());
+		});
+		solver.setCancelCallback([cancelled]() { return cancelled->load(); });
+
+		vector<int> assignment(solver.getNumberOfPoints());
+		SolverResult result = solver.solve(params, &assignment[0]);
+
+		stringstream line;
+		line << "result " << id << " " << (result.cancelled ? "cancelled" : "done");
+		line << " " << setprecision(8) << scientific << result.solutionValue;
+		line << " " << setprecision(4) << fixed << result.time << " " << result.nIterations << " ";
+		for(size_t i=0; i<assignment.size(); i++){
+			line << (i ? "," : "") << assignment[i];
+		}
+		session->send(line.str());
+	}catch(const exception& e){
+		session->send("error " + id + " " + e.what());
+	}
+	slots->release();
+	session->finishJob(id);
+}
+
+static void handleCommand(shared_ptr<Session> session, const string& line, bool& quit){
+	stringstream ss(line);
+	string command;
+	if(!(ss >> command)) return;
+
+	if(command == "solve"){
+		string id, path, option, options;
+		if(!(ss >> id >> path)){
+			session->send("error - usage: solve <id> <path> [name=value ...]");
+			return;
+		}
+		while(ss >> option) options += option + " ";
+
+		// Jobs in the daemon run against wall-clock budgets by default.
+		SolverParams params;
+		params.wallClock = true;
+		if(!params.parse(options)){
+			session->send("error " + id + " invalid options");
+			return;
+		}
+		shared_ptr< atomic<bool> > cancelled = session->startJob(id);
+		if(!cancelled){
+			session->send("error " + id + " duplicate job id");
+			return;
+		}
+		session->send("accepted " + id);
+		thread(runJob, session, id, path, params, cancelled).detach();
+	}else if(command == "cancel"){
+		string id;
+		ss >> id;
+		if(!session->cancel(id)){
+			session->send("error " + id + " unknown job");
+		}
+	}else if(command == "stats"){
+		stringstream out;
+		out << "stats instances=" << cache->getSize() << " bytes=" << cache->getBytes();
+		out << " hits=" << cache->getHits() << " misses=" << cache->getMisses();
+		out << " running=" << session->getRunning();
+		session->send(out.str());
+	}else if(command == "quit"){
+		quit = true;
+	}else{
+		session->send("error - unknown command " + command);
+	}
+}
+
+// Serves one client until it sends quit or closes its end. Outstanding jobs
+// finish before the session ends; socket clients that hang up get their jobs
+// cancelled, while end of input on stdin just waits for them.
+static void serve(shared_ptr<Session> session, bool cancelOnClose){
+	string line;
+	bool quit = false;
+	bool open = true;
+	while(!quit && (open = session->readLine(line))){
+		handleCommand(session, line, quit);
+	}
+	if(!open && cancelOnClose){
+		session->cancelAll();
+	}
+	session->waitJobs();
+}
+
+static void serveConnection(int fd){
+	serve(make_shared<Session>(fd, fd), true);
+	close(fd);
+}
+
+int main(int argc, char** argv) {
+	string socketPath;
+	size_t maxMemory = 1024;
+	int nJobs = thread::hardware_concurrency();
+	if(nJobs < 1) nJobs = 1;
+	CpuLevel cpuLevel;
+	HugePagePolicy hugePages = HUGEPAGES_TRANSPARENT;
+	bool prefault = false;
+
+	for(int i=1; i<argc; i++){
+		string arg = argv[i];
+		if(arg == "--socket" && i+1 < argc){
+			socketPath = argv[++i];
+		}else if(arg == "--memory" && i+1 < argc){
+			maxMemory = atol(argv[++i]);
+		}else if(arg == "--jobs" && i+1 < argc){
+			nJobs = atoi(argv[++i]);
+		}else if(arg == "--cpu" && i+1 < argc && parseCpuLevel(argv[i+1], cpuLevel)){
+			// Process-wide, like the memory policy, so not taken from the options of a job
+			setCpuLevel(cpuLevel);
+			i++;
+		}else if(arg == "--hugepages" && i+1 < argc && parseHugePagePolicy(argv[i+1], hugePages)){
+			i++;
+		}else if(arg == "--prefault"){
+			prefault = true;
+		}else{
+			cerr << "Usage: " << argv[0] << " [--socket <path>] [--memory <cache MB>] [--jobs <concurrent jobs>] [--cpu sse2|avx2|avx512]"
+					<< " [--hugepages off|thp|explicit] [--prefault]" << endl;
+			return EXIT_FAILURE;
+		}
+	}
+	if(nJobs < 1) nJobs = 1;
+	setHugePagePolicy(hugePages, prefault);
+
+	signal(SIGPIPE, SIG_IGN);
+	InstanceCache instanceCache(maxMemory << 20);
+	JobSlots jobSlots(nJobs);
+	cache = &instanceCache;
+	slots = &jobSlots;
+
+	if(socketPath.empty()){
+		serve(make_shared<Session>(0, 1), false);
+		return 0;
+	}
+
+	int server = socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if(server < 0 || socketPath.size() >= sizeof(address.sun_path)){
+		cerr << "PROBLEM CREATING THE SOCKET " << socketPath << endl;
+		return EXIT_FAILURE;
+	}
+	strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+	unlink(socketPath.c_str());
+	if(bind(server, (sockaddr*)&address, sizeof(address)) < 0 || listen(server, 16) < 0){
+		cerr << "PROBLEM BINDING THE SOCKET " << socketPath << ": " << strerror(errno) << endl;
+		return EXIT_FAILURE;
+	}
+
+	while(true){
+		int client = accept(server, NULL, NULL);
+		if(client < 0){
+			if(errno == EINTR) continue;
+			cerr << "PROBLEM ACCEPTING A CONNECTION: " << strerror(errno) << endl;
+			break;
+		}
+		thread(serveConnection, client).detach();
+	}
+	close(server);
+	unlink(socketPath.c_str());
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,95 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "lima_vns_c.h"
+#include "Solver.h"
+#include <new>
+#include <stdexcept>
+
+using namespace std;
+
+void lima_params_init(lima_params* params){
+	SolverParams defaults;
+	params->n_clusters = defaults.nClusters;
+	params->max_time = defaults.maxTime;
+	params->seed = defaults.seed;
+	params->k_min = defaults.kMin;
+	params->k_step = defaults.kStep;
+	params->k_max = defaults.kMax;
+	params->options = NULL;
+}
+
+static int runSolver(Solver& solver, const lima_params* params, lima_progress_fn progress,
+		lima_cancel_fn cancel, void* user_data, int* assignment, lima_result* result){
+	SolverParams solverParams;
+	solverParams.nClusters = params->n_clusters;
+	solverParams.maxTime = params->max_time;
+	solverParams.seed = params->seed;
+	solverParams.kMin = params->k_min;
+	solverParams.kStep = params->k_step;
+	solverParams.kMax = params->k_max;
+	if(params->options != NULL && !solverParams.parse(params->options)){
+		return LIMA_INVALID_ARGUMENT;
+	}
+
+	if(progress != NULL){
+		solver.setProgressCallback([progress, user_data](const SolverProgress& p) {
+			progress(user_data, p.iteration, p.solutionValue, p.time, p.k);
+		});
+	}
+	if(cancel != NULL){
+		solver.setCancelCallback([cancel, user_data]() {
+			return cancel(user_data) != 0;
+		});
+	}
+
+	SolverResult solverResult = solver.solve(solverParams, assignment);
+	if(result != NULL){
+		result->solution_value = solverResult.solutionValue;
+		result->time = solverResult.time;
+		result->n_iterations = solverResult.nIterations;
+	}
+	return solverResult.cancelled ? LIMA_CANCELLED : LIMA_OK;
+}
+
+int lima_solve_coordinates(const double* coordinates, int n_points, int n_dimensions,
+		const lima_params* params, lima_progress_fn progress, lima_cancel_fn cancel,
+		void* user_data, int* assignment, lima_result* result){
+	if(coordinates == NULL || params == NULL || assignment == NULL || n_points < 1 || n_dimensions < 1){
+		return LIMA_INVALID_ARGUMENT;
+	}
+	try{
+		Solver solver(coordinates, n_points, n_dimensions);
+		return runSolver(solver, params, progress, cancel, user_data, assignment, result);
+	}catch(const invalid_argument&){
+		return LIMA_INVALID_ARGUMENT;
+	}catch(const bad_alloc&){
+		return LIMA_OUT_OF_MEMORY;
+	}catch(...){
+		return LIMA_INTERNAL_ERROR;
+	}
+}
+
+int lima_solve_distances(const double* distances, int n_points,
+		const lima_params* params, lima_progress_fn progress, lima_cancel_fn cancel,
+		void* user_data, int* assignment, lima_result* result){
+	if(distances == NULL || params == NULL || assignment == NULL || n_points < 1){
+		return LIMA_INVALID_ARGUMENT;
+	}
+	try{
+		Solver solver(distances, n_points);
+		return runSolver(solver, params, progress, cancel, user_data, assignment, result);
+	}catch(const invalid_argument&){
+		return LIMA_INVALID_ARGUMENT;
+	}catch(const bad_alloc&){
+		return LIMA_OUT_OF_MEMORY;
+	}catch(...){
+		return LIMA_INTERNAL_ERROR;
+	}
+}
@@ -8,6 +8,7 @@
 //============================================================================
 
 #include "LocalSearch.h"
+#include "DeltaKernel.h"
 #include "Solution.h"
 #include <vector>
 #include "tempsC++.h"
@@ -20,6 +21,7 @@
 #include <map>
 #include <random>
 #include <cmath> // For fabs
+#include <thread>
 
 using namespace std;
 
@@ -28,43 +30,117 @@ LocalSearch::LocalSearch(vector<Point>* _dataset, Random* _random, vector< vecto
     dataset = _dataset;
     random = _random;
     rankedEntities = _rankedEntities;
+    cyclicLength = 0;
+    pairDescent = false;
+    parallel = NULL;
+    visited = NULL;
+    cutoffs = 0;
+}
+
+void LocalSearch::setCyclicExchange(int maxLength) {
+    cyclicLength = maxLength > 4 ? 4 : maxLength;
+}
+
+void LocalSearch::setVisited(VisitedSet* _visited) {
+    visited = _visited;
+}
+
+int LocalSearch::getCutoffs() {
+    return cutoffs;
+}
+
+LocalSearch::~LocalSearch() {
+    delete parallel;
+}
+
+void LocalSearch::setPairDescent(bool enabled) {
+    pairDescent = enabled;
+}
+
+void LocalSearch::setThreads(int nThreads) {
+    delete parallel;
+    parallel = NULL;
+    if (nThreads <= 0) nThreads = thread::hardware_concurrency();
+    if (nThreads > 1) parallel = new ParallelLocalSearch(nThreads);
+}
+
+void LocalSearch::setCancelCallback(function<bool()> callback) {
+    cancelCallback = callback;
+}
+
+// Checked once per outer loop of the pair scans so that the timer and the
+// cancellation stay off the per-pair path.
+bool LocalSearch::stopRequested(Chrono* timer, double maxTime) {
+    return timer->GetTime() > maxTime || (cancelCallback && cancelCallback());
 }
 
 // Main execution wrapper for the local search process.
 // It repeatedly applies the first-improvement heuristic until a local minimum is reached.
-void LocalSearch::execute(Solution& bestLocalSolution, ChronoCPU* timer, double maxTime, int nIteration) {
-    // Continuously apply the first-improvement swap search until no more improvements can be found.
-    while (swapLocalSearchFirstRand(bestLocalSolution, timer, maxTime));
+void LocalSearch::execute(Solution& bestLocalSolution, Chrono* timer, double maxTime, int nIteration) {
+    // Continuously apply the first-improvement swap search until no more improvements can be found,
+    // then try to escape the swap-local optimum with a cyclic exchange.
+    // A descent that starts from or reaches a local optimum seen before stops there.
+    // The pair descents end with an empty queue, at a swap local optimum, so
+    // they are not followed by a pass that would only confirm it.
+    while (true) {
+        if (visited && visited->contains(bestLocalSolution.hash)) {
+            cutoffs++;
+            break;
+        }
+        bool swapped;
+        bool converged = true;
+        if (parallel && bestLocalSolution.nClusters >= 4) {
+            swapped = parallel->descend(bestLocalSolution, random, visited,
+                                        [&]() { return stopRequested(timer, maxTime); });
+        } else if (pairDescent) {
+            swapped = swapLocalSearchPairs(bestLocalSolution, timer, maxTime);
+        } else {
+            swapped = swapLocalSearchFirstRand(bestLocalSolution, timer, maxTime);
+            converged = !swapped;
+        }
+        if (!converged) continue;
+        if (swapped && visited && visited->contains(bestLocalSolution.hash)) {
+            cutoffs++;
+            break;
+        }
+        if (!(cyclicLength >= 3 && cyclicExchange(bestLocalSolution, timer, maxTime))) break;
+    }
 }
 
 // Performs a best-improvement search.
 // It evaluates all possible swaps and executes the one that provides the maximum improvement.
 // Note: The LIMA-VNS paper uses a first-improvement strategy, but this is included for completeness.
-bool LocalSearch::swapLocalSearchBest(Solution& solution, ChronoCPU* timer, double maxTime) {
+bool LocalSearch::swapLocalSearchBest(Solution& solution, Chrono* timer, double maxTime) {
     double bestDelta = 1e-9; // Use a small positive epsilon to avoid floating point noise
     int bestI = -1, bestJ = -1;
 
+    // Only pairs in different clusters are enumerated, through the member
+    // lists; each pair is seen once, from its smaller index. The deltas are
+    // evaluated a block of partners at a time.
+    DeltaKernel kernel;
+    int block[DeltaKernel::BLOCK];
     for (int i = 0; i < solution.nDataPoints; i++) {
-        for (int j = i + 1; j < solution.nDataPoints; j++) {
-            if (timer->GetTime() > maxTime) return false;
-
-            int clusterI = solution.assignment[i];
-            int clusterJ = solution.assignment[j];
-
-            if (clusterI == clusterJ) continue;
-
-            double dist_ij = solution.distances->getDistance(i, j);
-            
-            // Calculate the change in objective function (delta) for swapping points i and j.
-            // This is the O(1) calculation derived from Huygens' theorem.
-            double delta = ( (solution.sc[j][clusterI] - solution.sc[i][clusterI] - dist_ij) / solution.clusterSizes[clusterI] ) +
-                           ( (solution.sc[i][clusterJ] - solution.sc[j][clusterJ] - dist_ij) / solution.clusterSizes[clusterJ] );
-
-
-            if (delta < bestDelta) {
-                bestDelta = delta;
-                bestI = i;
-                bestJ = j;
+        if (stopRequested(timer, maxTime)) return false;
+        solution.distances->useRow(i);
+        if (i + 1 < solution.nDataPoints) solution.distances->prefetchRow(i + 1);
+        int clusterI = solution.assignment[i];
+        for (int clusterJ = 0; clusterJ < solution.nClusters; clusterJ++) {
+            if (clusterJ == clusterI) continue;
+            const vector<int>& others = solution.members[clusterJ];
+            kernel.load(solution, i, clusterJ);
+            size_t m = 0;
+            while (m < others.size()) {
+                int count = 0;
+                for (; m < others.size() && count < DeltaKernel::BLOCK; m++) {
+                    if (others[m] > i) block[count++] = others[m];
+                }
+                double delta;
+                int found = kernel.bestImproving(block, count, bestDelta, delta);
+                if (found != -1) {
+                    bestDelta = delta;
+                    bestI = i;
+                    bestJ = block[found];
+                }
             }
         }
     }
@@ -80,40 +156,135 @@ bool LocalSearch::swapLocalSearchBest(Solution& solution, ChronoCPU* timer, doub
 
 // Performs a first-improvement search with a randomized starting point.
 // It iterates through all possible swaps and executes the *first* one that improves the solution.
-bool LocalSearch::swapLocalSearchFirstRand(Solution& solution, ChronoCPU* timer, double maxTime) {
+bool LocalSearch::swapLocalSearchFirstRand(Solution& solution, Chrono* timer, double maxTime) {
     // Create a shuffled list of indices to randomize the search starting point
     vector<int> indices(solution.nDataPoints);
     for(int i = 0; i < solution.nDataPoints; ++i) indices[i] = i;
     random->random_shuffle(indices.begin(), indices.end());
 
+    vector<int> rank(solution.nDataPoints);
+    for(int i_idx = 0; i_idx < solution.nDataPoints; ++i_idx) rank[indices[i_idx]] = i_idx;
+
+    // Only pairs in different clusters are enumerated, through the member
+    // lists; a pair is skipped if its other point came earlier in the order,
+    // since it was already evaluated then and nothing has changed since.
+    // The deltas are evaluated a block of partners at a time, and the time
+    // limit is checked once per point i.
+    DeltaKernel kernel;
+    int block[DeltaKernel::BLOCK];
     for (int i_idx = 0; i_idx < solution.nDataPoints; ++i_idx) {
         int i = indices[i_idx];
-        for (int j_idx = i_idx + 1; j_idx < solution.nDataPoints; ++j_idx) {
-            int j = indices[j_idx];
+        if (stopRequested(timer, maxTime)) return false;
+        solution.distances->useRow(i);
+        if (i_idx + 1 < solution.nDataPoints) solution.distances->prefetchRow(indices[i_idx + 1]);
+        int clusterI = solution.assignment[i];
+        for (int c = 1; c < solution.nClusters; c++) {
+            int clusterJ = (clusterI + c) % solution.nClusters;
+            const vector<int>& others = solution.members[clusterJ];
+            kernel.load(solution, i, clusterJ);
+            size_t m = 0;
+            while (m < others.size()) {
+                int count = 0;
+                for (; m < others.size() && count < DeltaKernel::BLOCK; m++) {
+                    if (rank[others[m]] > i_idx) block[count++] = others[m];
+                }
+                double delta;
+                int found = kernel.firstImproving(block, count, -1e-9, delta);
 
-            if (timer->GetTime() > maxTime) return false;
+                // If the delta is negative (an improvement), perform the swap and exit immediately.
+                if (found != -1) {
+                    swap(solution, i, block[found], delta);
+                    return true; // Improvement found and applied
+                }
+            }
+        }
+    }
 
-            int clusterI = solution.assignment[i];
-            int clusterJ = solution.assignment[j];
+    return false; // No improvement found after checking all pairs
+}
 
-            if (clusterI == clusterJ) continue;
+// A swap of points of clusters I and J changes the sc columns I and J and
+// the members of I and J, and nothing else: the sizes stay, so the delta of
+// every swap between two other clusters is unchanged. Every cluster pair
+// starts queued, in random order. A queued pair is descended with
+// first-improvement swaps until none of its swaps improves, which clears
+// it; if it made any swap, the cleared pairs touching either of its two
+// clusters are queued again. The descent ends at a swap local optimum when
+// the queue is empty, and rescans 2k-3 pairs after a pair changes instead
+// of all k(k-1)/2.
+// It also stops after a swap that reaches a visited local optimum, which
+// execute then counts, and returns false when the time runs out.
+bool LocalSearch::swapLocalSearchPairs(Solution& solution, Chrono* timer, double maxTime) {
+    int k = solution.nClusters;
+    pairIndex.assign((size_t)k * k, -1);
+    pairQueue.clear();
+    for (int a = 0; a < k; a++) {
+        for (int b = a + 1; b < k; b++) {
+            pairIndex[(size_t)a * k + b] = pairQueue.size();
+            pairQueue.push_back(a * k + b);
+        }
+    }
+    random->random_shuffle(pairQueue.begin(), pairQueue.end());
+    pairQueued.assign(pairQueue.size(), 1);
 
-            double dist_ij = solution.distances->getDistance(i, j);
+    DeltaKernel kernel;
+    int block[DeltaKernel::BLOCK];
+    bool improved = false;
+    for (size_t head = 0; head < pairQueue.size(); head++) {
+        if (stopRequested(timer, maxTime)) return false;
+        int clusterA = pairQueue[head] / k, clusterB = pairQueue[head] % k;
+        pairQueued[pairIndex[pairQueue[head]]] = 0;
 
-            // Calculate the change in objective function (delta) for swapping points i and j.
-            // This is the O(1) calculation derived from Huygens' theorem.
-            double delta = ( (solution.sc[j][clusterI] - solution.sc[i][clusterI] - dist_ij) / solution.clusterSizes[clusterI] ) +
-                           ( (solution.sc[i][clusterJ] - solution.sc[j][clusterJ] - dist_ij) / solution.clusterSizes[clusterJ] );
-            
-            // If the delta is negative (an improvement), perform the swap and exit immediately.
-            if (delta < -1e-9) {
-                swap(solution, i, j, delta);
-                return true; // Improvement found and applied
+        // Points of A are taken in a cycle, each against all of B, and the
+        // pair is clear once a whole cycle has passed since the last swap.
+        const vector<int>& pointsA = solution.members[clusterA];
+        const vector<int>& pointsB = solution.members[clusterB];
+        bool swapped = false;
+        // The time limit is checked every n or so deltas, as in the other scans.
+        size_t evaluated = 0;
+        for (size_t a = 0, checked = 0; checked < pointsA.size(); ) {
+            if (evaluated >= (size_t)solution.nDataPoints) {
+                if (stopRequested(timer, maxTime)) return false;
+                evaluated = 0;
+            }
+            evaluated += pointsB.size();
+            int i = pointsA[a];
+            solution.distances->useRow(i);
+            kernel.load(solution, i, clusterB);
+            int found = -1;
+            double delta;
+            for (size_t m = 0; m < pointsB.size() && found == -1; ) {
+                int count = 0;
+                for (; m < pointsB.size() && count < DeltaKernel::BLOCK; m++) block[count++] = pointsB[m];
+                found = kernel.firstImproving(block, count, -1e-9, delta);
+            }
+            if (found == -1) {
+                checked++;
+                a = (a + 1) % pointsA.size();
+                continue;
+            }
+            // The partner takes the place of i in A and is checked next.
+            swap(solution, i, block[found], delta);
+            swapped = true;
+            checked = 0;
+            if (visited && visited->contains(solution.hash)) return true;
+        }
+        if (!swapped) continue;
+        improved = true;
+        for (int c = 0; c < k; c++) {
+            for (int side = 0; side < 2; side++) {
+                int touched = side == 0 ? clusterA : clusterB;
+                if (c == touched) continue;
+                int key = min(c, touched) * k + max(c, touched);
+                int index = pairIndex[key];
+                if (key != pairQueue[head] && !pairQueued[index]) {
+                    pairQueued[index] = 1;
+                    pairQueue.push_back(key);
+                }
             }
         }
     }
-
-    return false; // No improvement found after checking all pairs
+    return improved;
 }
 
 // The core swap operation.
@@ -128,9 +299,11 @@ void LocalSearch::swap(Solution& solution, int pointI, int pointJ, double delta)
     // 2. Update the sc matrix in O(n)
     // For every point k, adjust its summed-distance for clusterI and clusterJ
     // to reflect the swap of pointI and pointJ.
+    solution.distances->useRow(pointI);
+    solution.distances->useRow(pointJ);
     for (int k = 0; k < solution.nDataPoints; k++) {
-        double dist_k_I = solution.distances->getDistance(k, pointI);
-        double dist_k_J = solution.distances->getDistance(k, pointJ);
+        double dist_k_I = solution.distances->getDistance(pointI, k);
+        double dist_k_J = solution.distances->getDistance(pointJ, k);
 
         // For clusterI, remove pointI's contribution and add pointJ's
         solution.sc[k][clusterI] = solution.sc[k][clusterI] - dist_k_I + dist_k_J;
@@ -140,10 +313,127 @@ void LocalSearch::swap(Solution& solution, int pointI, int pointJ, double delta)
     }
 
     // 3. Update the point assignments *after* the sc matrix has been updated
-    solution.assignment[pointI] = clusterJ;
-    solution.assignment[pointJ] = clusterI;
+    solution.swapPoints(pointI, pointJ);
+}
+
+
+// Points of each cluster considered for each move in the cyclic exchange.
+static const int CYCLE_CANDIDATES = 5;
+
+// Cyclic exchange: points[t], in clusters[t], moves to clusters[t+1] and the
+// last point closes the cycle into clusters[0], so every size is kept. The
+// cluster A_t that loses points[t] and receives points[t-1] changes by
+//   (sc[points[t-1]][A_t] - sc[points[t]][A_t] - d(points[t-1], points[t])) / |A_t|,
+// the same term as in the swap delta. Candidates for a move X -> Y are the
+// points of X with the smallest sc[p][Y]/|Y| - sc[p][X]/|X|.
+bool LocalSearch::cyclicExchange(Solution& solution, Chrono* timer, double maxTime) {
+    int k = solution.nClusters;
+    if (k < 3) return false;
+
+    vector< vector< vector<Pair> > > scored(k, vector< vector<Pair> >(k));
+    for (int p = 0; p < solution.nDataPoints; p++) {
+        int from = solution.assignment[p];
+        double stay = solution.sc[p][from] / solution.clusterSizes[from];
+        for (int to = 0; to < k; to++) {
+            if (to == from) continue;
+            scored[from][to].push_back(Pair(p, solution.sc[p][to] / solution.clusterSizes[to] - stay));
+        }
+    }
+    vector< vector< vector<int> > > candidates(k, vector< vector<int> >(k));
+    for (int from = 0; from < k; from++) {
+        for (int to = 0; to < k; to++) {
+            vector<Pair>& list = scored[from][to];
+            int m = min((int)list.size(), CYCLE_CANDIDATES);
+            partial_sort(list.begin(), list.begin() + m, list.end());
+            for (int c = 0; c < m; c++) candidates[from][to].push_back(list[c].getId());
+        }
+    }
+
+    vector<int> order(k);
+    for (int c = 0; c < k; c++) order[c] = c;
+    random->random_shuffle(order.begin(), order.end());
+
+    for (int o = 0; o < k; o++) {
+        if (stopRequested(timer, maxTime)) return false;
+        vector<int> clusters(1, order[o]);
+        vector<int> points;
+        if (searchCycle(solution, clusters, points, 0.0, candidates)) return true;
+    }
+    return false;
+}
+
+// Extends the path clusters[0] -> ... -> clusters.back() by one move and
+// tries to close it. partial is the exact change of the clusters that
+// already both lost and received a point.
+bool LocalSearch::searchCycle(Solution& solution, vector<int>& clusters, vector<int>& points, double partial,
+        const vector< vector< vector<int> > >& candidates) {
+    int k = solution.nClusters;
+    int length = clusters.size();
+    int current = clusters.back();
+
+    for (int next = 0; next < k; next++) {
+        if (find(clusters.begin(), clusters.end(), next) != clusters.end()) continue;
+        const vector<int>& moving = candidates[current][next];
+        for (size_t c = 0; c < moving.size(); c++) {
+            int p = moving[c];
+            double step = partial;
+            if (length > 1) {
+                int in = points.back();
+                step += (solution.sc[in][current] - solution.sc[p][current] - solution.distances->getDistance(in, p)) / solution.clusterSizes[current];
+            }
+            points.push_back(p);
+            clusters.push_back(next);
+
+            if (length + 1 >= 3) {
+                // Close the cycle: the last point of next goes back into clusters[0]
+                int first = clusters[0];
+                const vector<int>& closing = candidates[next][first];
+                for (size_t q = 0; q < closing.size(); q++) {
+                    int last = closing[q];
+                    int head = points[0];
+                    double delta = step
+                        + (solution.sc[p][next] - solution.sc[last][next] - solution.distances->getDistance(p, last)) / solution.clusterSizes[next]
+                        + (solution.sc[last][first] - solution.sc[head][first] - solution.distances->getDistance(last, head)) / solution.clusterSizes[first];
+                    if (delta < -1e-9) {
+                        points.push_back(last);
+                        cyclicMove(solution, clusters, points, delta);
+                        return true;
+                    }
+                }
+            }
+            if (length + 1 < cyclicLength && searchCycle(solution, clusters, points, step, candidates)) return true;
+
+            points.pop_back();
+            clusters.pop_back();
+        }
+    }
+    return false;
 }
 
+// Applies a cyclic exchange found by searchCycle in a single pass over sc.
+void LocalSearch::cyclicMove(Solution& solution, const vector<int>& clusters, const vector<int>& points, double delta) {
+    int length = clusters.size();
+    solution.solutionValue += delta;
+
+    // Cluster t loses points[t] and receives points[t-1]. One pass per
+    // cluster reads the rows of those two points, as the swap update does,
+    // so that the mapped storage loads rows rather than columns.
+    for (int t = 0; t < length; t++) {
+        int arriving = points[(t + length - 1) % length];
+        int leaving = points[t];
+        int cluster = clusters[t];
+        solution.distances->useRow(arriving);
+        solution.distances->useRow(leaving);
+        for (int x = 0; x < solution.nDataPoints; x++) {
+            solution.sc[x][cluster] += solution.distances->getDistance(arriving, x)
+                                     - solution.distances->getDistance(leaving, x);
+        }
+    }
+
+    for (int t = 0; t < length; t++) {
+        solution.movePoint(points[t], clusters[(t+1) % length]);
+    }
+}
 
 // A validation/debugging function to check solution integrity.
 // It re-calculates the objective function from scratch (slowly) and compares it
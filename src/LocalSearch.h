@@ -15,6 +15,9 @@
 #include <random>
 #include "Random.h"
 #include "Pair.h"
+#include <functional>
+#include "VisitedSet.h"
+#include "ParallelLocalSearch.h"
 
 using namespace std;
 
@@ -23,13 +26,55 @@ private:
 	vector<Point>* dataset;
 	Random* random;
 	vector< vector<Pair> >* rankedEntities;
+	function<bool()> cancelCallback;
+	int cyclicLength;
+	bool pairDescent;
+	ParallelLocalSearch* parallel;
+	VisitedSet* visited;
+	int cutoffs;
+
+	// swapLocalSearchPairs: index of every cluster pair (a < b) at a*k+b,
+	// the pairs still to scan and whether each one is queued
+	vector<int> pairIndex;
+	vector<int> pairQueue;
+	vector<char> pairQueued;
+
+	bool stopRequested(Chrono* timer, double maxTime);
+	bool searchCycle(Solution& solution, vector<int>& clusters, vector<int>& points, double partial,
+			const vector< vector< vector<int> > >& candidates);
 
 public:
 
 	LocalSearch(vector<Point>* _dataset, Random* _random, vector< vector<Pair> >* _rankedEntities);
-	void execute(Solution& bestLocalSolution, ChronoCPU* timer, double maxTime, int nIteration);
-	bool swapLocalSearchBest(Solution& solution, ChronoCPU* timer, double maxTime);
-	bool swapLocalSearchFirstRand(Solution& solution, ChronoCPU* timer, double maxTime);
+	LocalSearch(const LocalSearch&) = delete;
+	~LocalSearch();
+	void execute(Solution& bestLocalSolution, Chrono* timer, double maxTime, int nIteration);
+	void setCancelCallback(function<bool()> callback);
+	// Enables the cyclic exchange neighbourhood with cycles of up to maxLength
+	// clusters (3 or 4), explored whenever the swaps stall. 0 disables it.
+	void setCyclicExchange(int maxLength);
+	// After every improving move, execute stops if the solution is one of the
+	// visited local optima, saving the passes that would confirm it. NULL
+	// (the default) disables the check.
+	void setVisited(VisitedSet* _visited);
+	// Number of searches stopped on a visited local optimum.
+	int getCutoffs();
+	// Replaces the first-improvement swap scans of execute by
+	// swapLocalSearchPairs.
+	void setPairDescent(bool enabled);
+	// With more than one thread, execute descends the swaps of k >= 4
+	// clusters with a ParallelLocalSearch on nThreads threads (0 = all
+	// cores), started here and kept until destruction.
+	void setThreads(int nThreads);
+	bool swapLocalSearchBest(Solution& solution, Chrono* timer, double maxTime);
+	bool swapLocalSearchFirstRand(Solution& solution, Chrono* timer, double maxTime);
+	// Swap descent that only rescans the cluster pairs a swap can have
+	// changed. Returns true if it made any swap; unless it stopped early, it
+	// ends at a swap local optimum, which execute does not scan again.
+	bool swapLocalSearchPairs(Solution& solution, Chrono* timer, double maxTime);
+	bool cyclicExchange(Solution& solution, Chrono* timer, double maxTime);
+	// Moves points[t] into clusters[t+1] (cyclically) and updates sc with one pass per cluster of the cycle.
+	void cyclicMove(Solution& solution, const vector<int>& clusters, const vector<int>& points, double delta);
 	
     // CORRECTED FUNCTION DECLARATION
     void swap(Solution& solution, int pointI, int pointJ, double delta);
@@ -0,0 +1,108 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "Memory.h"
+#include <sys/mman.h>
+#include <stdint.h>
+#include <atomic>
+
+using namespace std;
+
+static const size_t HUGE_PAGE = (size_t)2 << 20;
+
+// Atomic since daemon jobs set them from their own threads
+static atomic<int> hugePagePolicy(HUGEPAGES_TRANSPARENT);
+static atomic<bool> prefaultPages(false);
+
+bool parseHugePagePolicy(const string& name, HugePagePolicy& policy){
+	if(name == "off") policy = HUGEPAGES_OFF;
+	else if(name == "thp") policy = HUGEPAGES_TRANSPARENT;
+	else if(name == "explicit") policy = HUGEPAGES_EXPLICIT;
+	else return false;
+	return true;
+}
+
+const char* backingName(MemoryBacking backing){
+	switch(backing){
+	case BACKING_HEAP: return "heap";
+	case BACKING_PAGES: return "4 KiB pages";
+	case BACKING_TRANSPARENT: return "transparent huge pages";
+	case BACKING_HUGETLBFS: return "hugetlbfs";
+	case BACKING_FILE: return "file";
+	}
+	return "unknown";
+}
+
+void setHugePagePolicy(HugePagePolicy policy, bool prefault){
+	hugePagePolicy = policy;
+	prefaultPages = prefault;
+}
+
+// Maps size bytes aligned to a huge page by over-allocating and trimming.
+static void* mapAligned(size_t size, int flags){
+	size_t padded = size + HUGE_PAGE;
+	char* raw = (char*)mmap(NULL, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+	if(raw == MAP_FAILED) return NULL;
+
+	char* aligned = (char*)(((uintptr_t)raw + HUGE_PAGE - 1) & ~(uintptr_t)(HUGE_PAGE - 1));
+	if(aligned > raw) munmap(raw, aligned - raw);
+	char* end = raw + padded;
+	if(end > aligned + size) munmap(aligned + size, end - (aligned + size));
+	return aligned;
+}
+
+MemoryBlock allocateBlock(size_t bytes){
+	MemoryBlock block;
+	block.data = NULL;
+	block.bytes = bytes;
+	block.backing = BACKING_HEAP;
+
+	bool prefault = prefaultPages;
+	int policy = hugePagePolicy;
+	if(policy != HUGEPAGES_OFF && bytes >= HUGE_PAGE){
+		size_t size = (bytes + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+#ifdef MAP_HUGETLB
+		if(policy == HUGEPAGES_EXPLICIT){
+			int populate = prefault ? MAP_POPULATE : 0;
+			void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+			if(data != MAP_FAILED){
+				block.data = data;
+				block.bytes = size;
+				block.backing = BACKING_HUGETLBFS;
+				return block;
+			}
+		}
+#endif
+		void* data = mapAligned(size, 0);
+		if(data != NULL){
+			block.data = data;
+			block.bytes = size;
+			block.backing = BACKING_PAGES;
+#ifdef MADV_HUGEPAGE
+			if(madvise(data, size, MADV_HUGEPAGE) == 0) block.backing = BACKING_TRANSPARENT;
+#endif
+			// Touch one byte per page now rather than on first use
+			if(prefault){
+				volatile char* page = (volatile char*)data;
+				for(size_t offset = 0; offset < size; offset += 4096) page[offset] = 0;
+			}
+			return block;
+		}
+	}
+
+	block.data = new char[bytes];
+	return block;
+}
+
+void releaseBlock(MemoryBlock& block){
+	if(block.data == NULL) return;
+	if(block.backing == BACKING_HEAP) delete [] (char*)block.data;
+	else munmap(block.data, block.bytes);
+	block.data = NULL;
+}
@@ -0,0 +1,55 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef MEMORY_H_
+#define MEMORY_H_
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+// Where a large block ended up.
+enum MemoryBacking {
+	BACKING_HEAP,          // plain new[]
+	BACKING_PAGES,         // anonymous mapping with 4 KiB pages
+	BACKING_TRANSPARENT,   // anonymous mapping advised for transparent huge pages
+	BACKING_HUGETLBFS,     // explicit huge pages from the hugetlbfs pool
+	BACKING_FILE           // shared mapping of a file, see STORAGE_MAPPED
+};
+
+enum HugePagePolicy {
+	HUGEPAGES_OFF,         // heap only
+	HUGEPAGES_TRANSPARENT, // madvise(MADV_HUGEPAGE) on 2 MiB aligned mappings, the default
+	HUGEPAGES_EXPLICIT     // MAP_HUGETLB first, then as HUGEPAGES_TRANSPARENT
+};
+
+struct MemoryBlock {
+	void* data;
+	size_t bytes;          // size of the mapping, rounded up to its page size
+	MemoryBacking backing;
+};
+
+// Converts "off", "thp" or "explicit"; returns false for other names.
+bool parseHugePagePolicy(const string& name, HugePagePolicy& policy);
+const char* backingName(MemoryBacking backing);
+
+// Process-wide settings for the blocks allocated afterwards. Blocks below
+// 2 MiB always come from the heap. Without prefaulting, pages are placed on
+// the node of the thread that first writes them (first touch), so arrays
+// filled by several threads are spread over their nodes; prefaulting maps
+// every page at allocation instead, from the allocating thread.
+void setHugePagePolicy(HugePagePolicy policy, bool prefault);
+
+// Returns a block of at least bytes bytes, zeroed when it is a mapping.
+// Falls back to the next backing whenever one is not available.
+MemoryBlock allocateBlock(size_t bytes);
+void releaseBlock(MemoryBlock& block);
+
+#endif /* MEMORY_H_ */
@@ -0,0 +1,221 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "Multilevel.h"
+#include "Vns.h"
+#include "LocalSearch.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+using namespace std;
+
+// Nearest neighbours tried before a point is left unmatched.
+static const int MATCHING_SCAN = 32;
+
+// Share of the time limit given to the VNS on the coarsest level.
+static const double COARSE_TIME_SHARE = 0.3;
+
+Multilevel::Multilevel(DistanceMatrix* _distances, vector< vector<Pair> >* _rankedEntities, Random* _random, const SolverParams& _params){
+	random = _random;
+	params = _params;
+	// The validator thread would count against a process CPU clock
+	if(params.wallTime()) timer = &wallTimer;
+	else if(params.validatePeriod > 0 || params.threadClock) timer = &threadTimer;
+	else timer = &cpuTimer;
+	validator = NULL;
+
+	Level* fine = new Level();
+	fine->nPoints = _distances->getSize();
+	fine->distances = _distances;
+	fine->rankedEntities = _rankedEntities;
+	fine->weight.assign(fine->nPoints, 1);
+	fine->meanWeight = 1.0;
+	levels.push_back(fine);
+}
+
+Multilevel::~Multilevel(){
+	for(size_t l=1; l<levels.size(); l++){
+		delete levels[l]->distances;
+	}
+	for(size_t l=0; l<levels.size(); l++){
+		delete levels[l];
+	}
+}
+
+void Multilevel::setProgressCallback(function<void(int, double, double, int)> callback){
+	progressCallback = callback;
+}
+
+void Multilevel::setCancelCallback(function<bool()> callback){
+	cancelCallback = callback;
+}
+
+void Multilevel::setValidator(Validator* _validator){
+	validator = _validator;
+}
+
+// Builds the next coarser level by a greedy nearest-neighbour matching in
+// random order. Returns false when the matching barely shrinks the instance.
+bool Multilevel::coarsen(){
+	Level* fine = levels.back();
+	int n = fine->nPoints;
+
+	vector<int> order(n);
+	for(int i=0; i<n; i++) order[i] = i;
+	random->random_shuffle(order.begin(), order.end());
+
+	fine->parent.assign(n, -1);
+	vector< vector<int> > members;
+	for(int o=0; o<n; o++){
+		int u = order[o];
+		if(fine->parent[u] != -1) continue;
+
+		fine->parent[u] = members.size();
+		members.push_back(vector<int>(1, u));
+
+		const vector<Pair>& neighbours = (*fine->rankedEntities)[u];
+		int scan = min((int)neighbours.size(), MATCHING_SCAN);
+		for(int r=0; r<scan; r++){
+			int v = neighbours[r].getId();
+			if(fine->parent[v] == -1){
+				fine->parent[v] = fine->parent[u];
+				members.back().push_back(v);
+				break;
+			}
+		}
+	}
+
+	int nCoarse = members.size();
+	if(nCoarse > 0.9*n){
+		fine->parent.clear();
+		return false;
+	}
+
+	// With w the weights and D the centroid distances of the finer level,
+	// whose matrix holds w_a w_b D(a,b) / meanWeight, the squared distance
+	// between the centroids of S and T is
+	//   sum over S x T of w_a w_b D(a,b) / (|S||T|) - W(S)/|S|^2 - W(T)/|T|^2,
+	// W the weighted pair sums within a super-point.
+	Level* coarse = new Level();
+	coarse->nPoints = nCoarse;
+	coarse->weight.assign(nCoarse, 0);
+	for(int s=0; s<nCoarse; s++){
+		for(size_t a=0; a<members[s].size(); a++){
+			coarse->weight[s] += fine->weight[members[s][a]];
+		}
+	}
+	coarse->meanWeight = fine->meanWeight * n / nCoarse;
+
+	vector<double> spread(nCoarse, 0.0);
+	for(int s=0; s<nCoarse; s++){
+		double w = 0.0;
+		for(size_t a=0; a<members[s].size(); a++){
+			for(size_t b=a+1; b<members[s].size(); b++){
+				w += fine->distances->getDistance(members[s][a], members[s][b]) * fine->meanWeight;
+			}
+		}
+		spread[s] = w / ((double)coarse->weight[s]*coarse->weight[s]);
+	}
+
+	coarse->distances = new DistanceMatrix(nCoarse);
+	coarse->rankedEntities = &coarse->ownedRankedEntities;
+	for(int s=0; s<nCoarse; s++){
+		for(int t=s+1; t<nCoarse; t++){
+			double cross = 0.0;
+			for(size_t a=0; a<members[s].size(); a++){
+				for(size_t b=0; b<members[t].size(); b++){
+					cross += fine->distances->getDistance(members[s][a], members[t][b]);
+				}
+			}
+			double weights = (double)coarse->weight[s]*coarse->weight[t];
+			double d = cross * fine->meanWeight / weights - spread[s] - spread[t];
+			coarse->distances->setDistance(s, t, weights * max(d, 0.0) / coarse->meanWeight);
+		}
+	}
+	levels.push_back(coarse);
+	return true;
+}
+
+// Gives every point of fineLevel the cluster of its super-point, then fixes
+// the cluster sizes, which only match approximately after unmatched points.
+void Multilevel::project(Solution& coarse, Solution& fine, Level* fineLevel){
+	for(int c=0; c<fine.nClusters; c++){
+		fine.clusterSizes[c] = 0;
+	}
+	for(int i=0; i<fine.nDataPoints; i++){
+		fine.assignment[i] = coarse.assignment[fineLevel->parent[i]];
+		fine.clusterSizes[fine.assignment[i]]++;
+	}
+	fine.initializeSc();
+	fine.rebalance();
+}
+
+int Multilevel::execute(Solution& solution, double maxTime, int kMin, int kStep, int kMax){
+	int nClusters = solution.nClusters;
+	int coarsest = max(params.coarsestSize, 20*nClusters);
+
+	timer->Reset();
+	timer->Start();
+	while(levels.back()->nPoints > coarsest){
+		Level* level = levels.back();
+		if(level->rankedEntities == NULL || level->rankedEntities->empty()){
+			level->distances->rankEntities(level->ownedRankedEntities, MATCHING_SCAN);
+			level->rankedEntities = &level->ownedRankedEntities;
+		}
+		if(!coarsen()) break;
+		if(timer->GetTime() > maxTime*COARSE_TIME_SHARE) break;
+	}
+
+	int top = levels.size() - 1;
+	if(params.verbose){
+		cout << "Multilevel: " << levels.size() << " levels, coarsest has " << levels[top]->nPoints << " points" << endl;
+	}
+
+	int iterations = 0;
+	Solution* current = NULL;
+	if(top > 0){
+		Level* level = levels[top];
+		current = new Solution(nClusters, level->nPoints, level->distances);
+		Vns vns(NULL, level->distances, nClusters, random, level->rankedEntities);
+		params.configure(vns);
+		vns.setTimer(timer);
+		vns.setCancelCallback(cancelCallback);
+		int levelKMax = level->nPoints/2;
+		iterations += vns.execute(*current, maxTime*COARSE_TIME_SHARE, kMin, max(1, levelKMax/20), levelKMax, "");
+		timer->Start();
+
+		LocalSearch localSearch(NULL, random, NULL);
+		localSearch.setCancelCallback(cancelCallback);
+		localSearch.setCyclicExchange(params.cyclicLength);
+		localSearch.setPairDescent(params.pairDescent);
+		localSearch.setThreads(params.searchThreads);
+		for(int l=top-1; l>=0; l--){
+			Solution* finer = l > 0 ? new Solution(nClusters, levels[l]->nPoints, levels[l]->distances) : &solution;
+			project(*current, *finer, levels[l]);
+			delete current;
+			current = finer;
+			localSearch.execute(*current, timer, maxTime, iterations);
+			if(params.verbose){
+				cout << "Level " << l << " (" << levels[l]->nPoints << " points) refined to " << fixed << setprecision(5) << current->solutionValue << endl;
+			}
+		}
+	}
+
+	// Carry on at full resolution with the remaining time
+	Vns vns(NULL, levels[0]->distances, nClusters, random, levels[0]->rankedEntities);
+	params.configure(vns);
+	vns.setTimer(timer);
+	vns.setWarmStart(top > 0);
+	vns.setProgressCallback(progressCallback);
+	vns.setCancelCallback(cancelCallback);
+	vns.setValidator(validator);
+	iterations += vns.execute(solution, maxTime, kMin, kStep, kMax, "");
+	return iterations;
+}
@@ -0,0 +1,76 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef MULTILEVEL_H_
+#define MULTILEVEL_H_
+
+#include <vector>
+#include <functional>
+#include "Solution.h"
+#include "DistanceMatrix.h"
+#include "Pair.h"
+#include "Random.h"
+#include "Solver.h"
+#include "tempsC++.h"
+#include "Validator.h"
+
+using namespace std;
+
+// Coarsen-solve-refine driver for large instances. Each coarsening level
+// matches every point with its nearest unmatched neighbour into a super-point
+// that keeps the number of original points it holds, its weight. The distance
+// of two super-points S and T is |S||T| times the squared distance of their
+// centroids, over the mean weight of the level: the cross term of the
+// objective of a cluster holding both, scaled so that the VNS, which divides
+// by the number of super-points of a cluster, sees the objective of the
+// original points whenever weights are close to the mean. The balance of the
+// coarse levels is still kept on super-points, not weights, since swaps can
+// only keep counts; the matching leaves weights within a factor of two of
+// each other, and the projection rebalances the exact sizes. The coarsest
+// level is solved with the VNS, and the assignment is projected back level by
+// level, rebalanced and refined with the local search. Whatever time is left
+// is spent by the VNS on the original instance.
+class Multilevel {
+public:
+	Multilevel(DistanceMatrix* _distances, vector< vector<Pair> >* _rankedEntities, Random* _random, const SolverParams& _params);
+	~Multilevel();
+
+	int execute(Solution& solution, double maxTime, int kMin, int kStep, int kMax);
+	void setProgressCallback(function<void(int, double, double, int)> callback);
+	void setCancelCallback(function<bool()> callback);
+	// Forwarded to the VNS on the full instance.
+	void setValidator(Validator* _validator);
+
+private:
+	struct Level {
+		int nPoints;
+		DistanceMatrix* distances;
+		vector< vector<Pair> >* rankedEntities;
+		vector< vector<Pair> > ownedRankedEntities;
+		vector<int> parent;   // super-point of the next coarser level holding each point
+		vector<int> weight;   // original points held by each point
+		double meanWeight;    // distances are |S||T| D(S,T) / meanWeight, see above
+	};
+
+	Random* random;
+	SolverParams params;
+	vector<Level*> levels;
+	ChronoCPU cpuTimer;
+	ChronoReal wallTimer;
+	ChronoThread threadTimer;
+	Chrono* timer;
+	Validator* validator;
+
+	function<void(int, double, double, int)> progressCallback;
+	function<bool()> cancelCallback;
+
+	bool coarsen();
+	void project(Solution& coarse, Solution& fine, Level* fineLevel);
+};
+#endif /* MULTILEVEL_H_ */
@@ -0,0 +1,144 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "OnlineInsertion.h"
+#include "DeltaKernel.h"
+#include <float.h>
+#include <algorithm>
+
+using namespace std;
+
+OnlineInsertion::OnlineInsertion(int _maxMoves){
+	maxMoves = _maxMoves;
+}
+
+int OnlineInsertion::insert(Solution& solution){
+	int first = solution.nDataPoints;
+	int n = solution.distances->getSize();
+	if(n <= first) return 0;
+	solution.resize(n);
+
+	vector<int> points;
+	for(int p=first; p<n; p++) points.push_back(p);
+	return assignPoints(solution, points);
+}
+
+int OnlineInsertion::assignPoints(Solution& solution, const vector<int>& points){
+	int n = solution.nDataPoints;
+	int k = solution.nClusters;
+
+	// Final sizes, measured as if the new points were already in place
+	vector<int> quota;
+	solution.balancedTargets(quota);
+	for(int c=0; c<k; c++){
+		quota[c] -= (int)solution.clusterSizes[c];
+	}
+
+	pairSum.assign(k, 0.0);
+	for(int i=0; i<n; i++){
+		int c = solution.assignment[i];
+		if(c >= 0) pairSum[c] += solution.sc[i][c] / 2.0;
+	}
+	distance.resize(n);
+	for(size_t p=0; p<points.size(); p++){
+		assign(solution, points[p], quota);
+	}
+	return repair(solution, points);
+}
+
+void OnlineInsertion::assign(Solution& solution, int point, vector<int>& quota){
+	int n = solution.nDataPoints;
+	int k = solution.nClusters;
+
+	// The lower triangle row covers j <= point; when the point was appended
+	// nothing after it is assigned yet and the column is skipped
+	const double* lower = solution.distances->getRow(point, &distance[0]);
+	if(lower != &distance[0]) copy(lower, lower + point + 1, distance.begin());
+	double* row = solution.sc[point];
+	for(int c=0; c<k; c++) row[c] = 0.0;
+	for(int j=0; j<n; j++){
+		if(solution.assignment[j] < 0) continue;
+		if(j > point) distance[j] = solution.distances->getDistance(point, j);
+		row[solution.assignment[j]] += distance[j];
+	}
+
+	// Cheapest cluster with free quota, or cheapest of all if the solution was unbalanced
+	int best = -1;
+	double bestCost = DBL_MAX;
+	for(int pass=0; pass<2 && best == -1; pass++){
+		for(int c=0; c<k; c++){
+			if(pass == 0 && quota[c] <= 0) continue;
+			double size = solution.clusterSizes[c];
+			double cost = size > 0 ? (pairSum[c] + row[c]) / (size + 1) - pairSum[c] / size : 0.0;
+			if(cost < bestCost){
+				bestCost = cost;
+				best = c;
+			}
+		}
+	}
+
+	for(int j=0; j<n; j++){
+		if(solution.assignment[j] >= 0) solution.sc[j][best] += distance[j];
+	}
+	solution.solutionValue += bestCost;
+	pairSum[best] += row[best];
+	quota[best]--;
+	solution.placePoint(point, best);
+}
+
+int OnlineInsertion::repair(Solution& solution, const vector<int>& points){
+	int n = solution.nDataPoints;
+	int budget = maxMoves * points.size();
+	LocalSearch localSearch(NULL, NULL, NULL);
+	DeltaKernel kernel;
+	int block[DeltaKernel::BLOCK];
+
+	vector<int> queue(points);
+	vector<char> queued(n, 0);
+	for(size_t p=0; p<points.size(); p++){
+		queued[points[p]] = 1;
+	}
+
+	int moves = 0;
+	for(size_t head=0; head<queue.size() && moves<budget; head++){
+		int i = queue[head];
+		queued[i] = 0;
+		int clusterI = solution.assignment[i];
+
+		double bestDelta = -1e-9;
+		int bestJ = -1;
+		for(int c=0; c<solution.nClusters; c++){
+			if(c == clusterI) continue;
+			const vector<int>& others = solution.members[c];
+			kernel.load(solution, i, c);
+			for(size_t m=0; m<others.size(); m+=DeltaKernel::BLOCK){
+				int count = min((size_t)DeltaKernel::BLOCK, others.size() - m);
+				copy(others.begin() + m, others.begin() + m + count, block);
+				double delta;
+				int found = kernel.bestImproving(block, count, bestDelta, delta);
+				if(found != -1){
+					bestDelta = delta;
+					bestJ = block[found];
+				}
+			}
+		}
+		if(bestJ == -1) continue;
+
+		localSearch.swap(solution, i, bestJ, bestDelta);
+		moves++;
+		int moved[2] = {i, bestJ};
+		for(int t=0; t<2; t++){
+			if(!queued[moved[t]]){
+				queue.push_back(moved[t]);
+				queued[moved[t]] = 1;
+			}
+		}
+	}
+	return moves;
+}
@@ -0,0 +1,49 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef ONLINEINSERTION_H_
+#define ONLINEINSERTION_H_
+
+#include <vector>
+#include "Solution.h"
+#include "LocalSearch.h"
+
+using namespace std;
+
+// Assigns points appended to the distance matrix of a solved instance (see
+// DistanceMatrix::addPoints) without solving it again. Cluster quotas are
+// fixed first so that the final sizes are balanced, the largest clusters
+// taking the larger size. Then each new point, in arrival order, joins the
+// cluster with free quota where it raises the objective least, which costs
+// one pass over its row of distances to fill its sc row and one to add it
+// to the other sc rows. A bounded repair follows: the best improving swap
+// of each new point, and of every point it displaces, is applied until none
+// improves or maxMoves swaps per new point were made.
+class OnlineInsertion {
+public:
+	OnlineInsertion(int _maxMoves);
+
+	// Grows solution, which must be balanced with a consistent sc, to the
+	// size of its distance matrix and assigns the new points. Returns the
+	// number of repair swaps.
+	int insert(Solution& solution);
+	// Same for the given unassigned points of solution, wherever they are;
+	// sc must be consistent for the assigned points. Clusters left oversized
+	// by earlier removals keep their extra points.
+	int assignPoints(Solution& solution, const vector<int>& points);
+
+private:
+	int maxMoves;
+	vector<double> pairSum;   // half the sum of sc[i][c] over the points of c
+	vector<double> distance;  // distances of the point being assigned
+
+	void assign(Solution& solution, int point, vector<int>& quota);
+	int repair(Solution& solution, const vector<int>& points);
+};
+#endif /* ONLINEINSERTION_H_ */
@@ -0,0 +1,202 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "ParallelLocalSearch.h"
+#include "DeltaKernel.h"
+#include <chrono>
+
+// Milliseconds between the polls of stop while the caller waits at the barrier.
+static const int STOP_POLL_MS = 1;
+
+ParallelLocalSearch::ParallelLocalSearch(int nThreads){
+	if(nThreads <= 0) nThreads = thread::hardware_concurrency();
+	generation = 0;
+	pending = 0;
+	exiting = false;
+	solution = NULL;
+	nextPair = 0;
+	stopping = false;
+	for(int t=1; t<nThreads; t++){
+		workers.push_back(thread(&ParallelLocalSearch::work, this));
+	}
+}
+
+ParallelLocalSearch::~ParallelLocalSearch(){
+	{
+		lock_guard<mutex> guard(lock);
+		exiting = true;
+	}
+	wake.notify_all();
+	for(size_t t=0; t<workers.size(); t++){
+		workers[t].join();
+	}
+}
+
+int ParallelLocalSearch::getThreads(){
+	return workers.size() + 1;
+}
+
+void ParallelLocalSearch::work(){
+	int seen = 0;
+	while(true){
+		{
+			unique_lock<mutex> guard(lock);
+			wake.wait(guard, [&]{ return exiting || generation != seen; });
+			if(exiting) return;
+			seen = generation;
+		}
+		takePairs(false);
+		lock_guard<mutex> guard(lock);
+		if(--pending == 0) finished.notify_one();
+	}
+}
+
+// The calling thread takes pairs too, then waits for the others at the barrier.
+void ParallelLocalSearch::runRound(){
+	nextPair = 0;
+	{
+		lock_guard<mutex> guard(lock);
+		generation++;
+		pending = workers.size();
+	}
+	wake.notify_all();
+	takePairs(true);
+	// Keeps polling stop for the pairs still running on the other threads
+	unique_lock<mutex> guard(lock);
+	while(!finished.wait_for(guard, chrono::milliseconds(STOP_POLL_MS), [&]{ return pending == 0; })){
+		guard.unlock();
+		if(!stopping && stop && stop()) stopping = true;
+		guard.lock();
+	}
+}
+
+void ParallelLocalSearch::takePairs(bool caller){
+	int index;
+	while((index = nextPair++) < (int)roundPairs.size()){
+		descendPair(index, caller);
+	}
+}
+
+// First-improvement swaps between the points of A, taken in a cycle, and
+// all of B, until a whole cycle passes without one. Only the sc columns A
+// and B and the members of A and B are written.
+void ParallelLocalSearch::descendPair(int index, bool caller){
+	Solution& s = *solution;
+	int k = s.nClusters;
+	int clusterA = roundPairs[index] / k, clusterB = roundPairs[index] % k;
+	const vector<int>& pointsA = s.members[clusterA];
+	const vector<int>& pointsB = s.members[clusterB];
+
+	DeltaKernel kernel;
+	int block[DeltaKernel::BLOCK];
+	for(size_t a = 0, checked = 0; checked < pointsA.size(); ){
+		if(stopping) return;
+		if(caller && stop && stop()){
+			stopping = true;
+			return;
+		}
+		int i = pointsA[a];
+		s.distances->useRow(i);
+		kernel.load(s, i, clusterB);
+		int found = -1;
+		double delta;
+		for(size_t m = 0; m < pointsB.size() && found == -1; ){
+			int count = 0;
+			for(; m < pointsB.size() && count < DeltaKernel::BLOCK; m++) block[count++] = pointsB[m];
+			found = kernel.firstImproving(block, count, -1e-9, delta);
+		}
+		if(found == -1){
+			checked++;
+			a = (a + 1) % pointsA.size();
+			continue;
+		}
+
+		int j = block[found];
+		s.distances->useRow(j);
+		for(int p=0; p<s.nDataPoints; p++){
+			double dI = s.distances->getDistance(i, p);
+			double dJ = s.distances->getDistance(j, p);
+			s.sc[p][clusterA] += dJ - dI;
+			s.sc[p][clusterB] += dI - dJ;
+		}
+		s.exchangePoints(i, j);
+		gains[index] += delta;
+		swapped[index] = 1;
+		checked = 0;
+	}
+}
+
+bool ParallelLocalSearch::descend(Solution& s, Random* random, VisitedSet* visited, function<bool()> _stop){
+	int k = s.nClusters;
+	solution = &s;
+	stop = _stop;
+	stopping = false;
+
+	// Seats of the circle method over a random labelling, -1 for the bye
+	int seats = k + k % 2;
+	vector<int> order(seats, -1);
+	for(int c=0; c<k; c++) order[c] = c;
+	random->random_shuffle(order.begin(), order.begin() + k);
+
+	vector<char> dirty((size_t)k * k, 0);
+	int nDirty = 0;
+	for(int a=0; a<k; a++){
+		for(int b=a+1; b<k; b++){
+			dirty[(size_t)a * k + b] = 1;
+			nDirty++;
+		}
+	}
+
+	bool improved = false;
+	for(int round = 0; nDirty > 0; round = (round + 1) % (seats - 1)){
+		// Seat 0 stays, the others rotate by one per round; seat t plays
+		// seat seats-1-t.
+		roundPairs.clear();
+		for(int t=0; t<seats/2; t++){
+			int first = t == 0 ? 0 : 1 + (t - 1 + round) % (seats - 1);
+			int second = 1 + (seats - 2 - t + round) % (seats - 1);
+			int a = order[first], b = order[second];
+			if(a == -1 || b == -1) continue;
+			int key = min(a, b) * k + max(a, b);
+			if(!dirty[key]) continue;
+			dirty[key] = 0;
+			nDirty--;
+			roundPairs.push_back(key);
+		}
+		if(roundPairs.empty()) continue;
+
+		gains.assign(roundPairs.size(), 0.0);
+		swapped.assign(roundPairs.size(), 0);
+		runRound();
+
+		bool any = false;
+		for(size_t p=0; p<roundPairs.size(); p++){
+			s.solutionValue += gains[p];
+			if(!swapped[p]) continue;
+			any = true;
+			int touched[2] = {roundPairs[p] / k, roundPairs[p] % k};
+			for(int side=0; side<2; side++){
+				for(int c=0; c<k; c++){
+					if(c == touched[side]) continue;
+					int key = min(c, touched[side]) * k + max(c, touched[side]);
+					if(key == roundPairs[p] || dirty[key]) continue;
+					dirty[key] = 1;
+					nDirty++;
+				}
+			}
+		}
+		if(any){
+			s.rebuildHash();
+			improved = true;
+		}
+		if(stopping) return false;
+		if(any && visited && visited->contains(s.hash)) return true;
+	}
+	return improved;
+}
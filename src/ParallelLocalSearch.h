@@ -0,0 +1,77 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef PARALLELLOCALSEARCH_H_
+#define PARALLELLOCALSEARCH_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include "Solution.h"
+#include "Random.h"
+#include "VisitedSet.h"
+
+using namespace std;
+
+// Swap descent over cluster pairs on a pool of threads. Swaps between the
+// points of clusters A and B change only the sc columns A and B and the
+// members and cluster hashes of A and B, so pairs with no cluster in common
+// are descended at the same time without locks. The pairs are taken in the
+// rounds of a round-robin schedule (circle method: k clusters, plus a bye if
+// k is odd, give k-1 or k rounds of disjoint pairs that cover every pair
+// once), and the threads meet at a barrier after each round, where the gains
+// are added to the value and the hash is rebuilt. As in
+// LocalSearch::swapLocalSearchPairs, a pair is only descended again once a
+// swap has touched one of its clusters. The pairs of a round commute and
+// their gains are summed in pair order, so the result does not depend on the
+// number of threads.
+class ParallelLocalSearch {
+public:
+	// nThreads counts the calling thread; 0 takes all cores. The other
+	// threads are started here and wait for rounds until destruction.
+	ParallelLocalSearch(int nThreads);
+	~ParallelLocalSearch();
+	int getThreads();
+
+	// Descends to a swap local optimum; returns true if it made any swap.
+	// It also returns after a round that ends on a hash in visited (may be
+	// NULL). stop is polled only by the calling thread, between the points it
+	// scans and every STOP_POLL_MS while it waits for the others, and all
+	// threads leave their pair when it fires; the descent then returns false
+	// with the solution consistent.
+	bool descend(Solution& solution, Random* random, VisitedSet* visited, function<bool()> stop);
+
+private:
+	vector<thread> workers;
+	mutex lock;
+	condition_variable wake;
+	condition_variable finished;
+	int generation;
+	int pending;
+	bool exiting;
+
+	// Current round: the pairs (a*k+b, a < b), the next one to take, and the
+	// gain and whether any swap was made for each
+	Solution* solution;
+	function<bool()> stop;
+	vector<int> roundPairs;
+	vector<double> gains;
+	vector<char> swapped;
+	atomic<int> nextPair;
+	atomic<bool> stopping;
+
+	void work();
+	void runRound();
+	void takePairs(bool caller);
+	void descendPair(int index, bool caller);
+};
+#endif /* PARALLELLOCALSEARCH_H_ */
@@ -0,0 +1,150 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "Planner.h"
+#include "Pair.h"
+#include <unistd.h>
+#include <sys/statvfs.h>
+#include <iomanip>
+#include <algorithm>
+
+using namespace std;
+
+// Cost model, in seconds: one multiply-add of the tiled distance build, one
+// distance read from a stored triangle, and one coordinate of a distance
+// recomputed on the fly. Rough single-core figures; they only rank options.
+static const double BUILD_FLOP = 0.5e-9;
+static const double STORED_READ = 2e-9;
+static const double ONTHEFLY_COORDINATE = 0.7e-9;
+// Bytes per second written and read by the mapped storage.
+static const double DISK_BANDWIDTH = 1e9;
+// Local search passes a run is assumed to make when the one-off build of the
+// mapped file is weighed against recomputing the distances on every pass.
+static const int EXPECTED_PASSES = 10;
+// Rows the mapped storage caches at least, see DistanceMatrix.
+static const size_t MAPPED_MIN_ROWS = 4;
+
+// Neighbours kept per point for the multilevel matching, see Multilevel.
+static const size_t MULTILEVEL_NEIGHBOURS = 32;
+
+static const DistanceStorage STORAGES[] = { STORAGE_DOUBLE, STORAGE_FLOAT, STORAGE_MAPPED, STORAGE_ONTHEFLY };
+static const int N_STORAGES = 4;
+
+Planner::Planner(int _nPoints, int _nDimensions, int _nClusters, bool _multilevel){
+	nPoints = _nPoints;
+	nDimensions = _nDimensions;
+	nClusters = _nClusters;
+	multilevel = _multilevel;
+	cacheBytes = 0;
+}
+
+size_t Planner::physicalMemory(){
+	long pages = sysconf(_SC_PHYS_PAGES);
+	long pageSize = sysconf(_SC_PAGESIZE);
+	if(pages <= 0 || pageSize <= 0) return 0;
+	return (size_t)pages * (size_t)pageSize;
+}
+
+size_t Planner::estimateBytes(DistanceStorage storage){
+	size_t n = nPoints, d = nDimensions, k = nClusters;
+	size_t triangle = n*(n+1)/2;
+
+	// Points, plus the centred copy kept by the distance matrix
+	size_t bytes = n*(d*sizeof(double) + 32) + n*d*sizeof(double);
+	// Best, working and per-run solutions: sc, row pointers, assignment and member lists
+	bytes += 3 * n*(k*sizeof(double) + sizeof(double*) + 3*sizeof(int));
+
+	if(storage == STORAGE_DOUBLE) bytes += triangle*sizeof(double) + n*sizeof(double*);
+	else if(storage == STORAGE_FLOAT) bytes += triangle*sizeof(float) + n*sizeof(float*);
+	else if(storage == STORAGE_MAPPED) bytes += cacheBytes + n*d*sizeof(double);
+
+	if(multilevel){
+		// Neighbour lists, and coarse levels of at most n/2, n/4, ... points
+		// stored as double triangles, about 4/3 of the first one
+		bytes += n*MULTILEVEL_NEIGHBOURS*sizeof(Pair);
+		size_t half = n/2;
+		bytes += half*(half+1)/2*sizeof(double) * 4/3;
+	}
+	return bytes;
+}
+
+double Planner::estimateSeconds(DistanceStorage storage){
+	return buildSeconds(storage) + passSeconds(storage);
+}
+
+double Planner::buildSeconds(DistanceStorage storage){
+	double n = nPoints, d = nDimensions;
+	double pairs = n*(n-1)/2;
+	if(storage == STORAGE_ONTHEFLY) return 0.0;
+	// Full rows: every pair is computed and written twice
+	if(storage == STORAGE_MAPPED) return 2*pairs * d * BUILD_FLOP + n*n*sizeof(double) / DISK_BANDWIDTH;
+	return pairs * d * BUILD_FLOP;
+}
+
+double Planner::passSeconds(DistanceStorage storage){
+	double n = nPoints, d = nDimensions;
+	double pairs = n*(n-1)/2;
+	if(storage == STORAGE_ONTHEFLY) return pairs * d * ONTHEFLY_COORDINATE;
+	if(storage == STORAGE_MAPPED){
+		// The part of the file the cache cannot hold is read once
+		double fileBytes = n*n*sizeof(double);
+		double missing = fileBytes > 0 ? max(0.0, 1.0 - cacheBytes / fileBytes) : 0.0;
+		return pairs * STORED_READ + missing * fileBytes / DISK_BANDWIDTH;
+	}
+	return pairs * STORED_READ;
+}
+
+DistanceStorage Planner::choose(size_t maxBytes, ostream* log){
+	if(maxBytes == 0) maxBytes = physicalMemory() / 10 * 8;
+
+	// Page aligned rows of the mapped file, as laid out by DistanceMatrix
+	size_t pageDoubles = sysconf(_SC_PAGESIZE) / sizeof(double);
+	size_t rowBytes = (nPoints + pageDoubles - 1) / pageDoubles * pageDoubles * sizeof(double);
+	size_t fileBytes = nPoints * rowBytes;
+	size_t base = estimateBytes(STORAGE_ONTHEFLY);
+	cacheBytes = MAPPED_MIN_ROWS * rowBytes;
+	if(mappedCacheBytes() > 0) cacheBytes = mappedCacheBytes();
+	else if(maxBytes > base + nPoints*nDimensions*sizeof(double) + cacheBytes) cacheBytes = maxBytes - base - nPoints*nDimensions*sizeof(double);
+	cacheBytes = min(cacheBytes, fileBytes);
+	struct statvfs disk;
+	bool diskFits = statvfs(mappedDirectory().c_str(), &disk) == 0 && (size_t)disk.f_bavail * disk.f_frsize >= fileBytes;
+
+	// The storages are listed from the fastest to the smallest, except that
+	// recomputing few dimensions can beat reading the mapped file over a run
+	DistanceStorage chosen = STORAGES[N_STORAGES-1];
+	double chosenSeconds = 0.0;
+	bool found = false;
+	for(int s=0; s<N_STORAGES; s++){
+		size_t bytes = estimateBytes(STORAGES[s]);
+		double seconds = estimateSeconds(STORAGES[s]);
+		double runSeconds = buildSeconds(STORAGES[s]) + EXPECTED_PASSES * passSeconds(STORAGES[s]);
+		bool fits = maxBytes == 0 || bytes <= maxBytes;
+		bool onDisk = STORAGES[s] != STORAGE_MAPPED || diskFits;
+		if(fits && onDisk && (!found || (chosen == STORAGE_MAPPED && runSeconds < chosenSeconds))){
+			chosen = STORAGES[s];
+			chosenSeconds = runSeconds;
+			found = true;
+		}
+		if(log != NULL){
+			*log << "Plan: " << storageName(STORAGES[s]) << " needs " << fixed << setprecision(1) << bytes / 1048576.0 << " MB";
+			if(STORAGES[s] == STORAGE_MAPPED) *log << " and " << fileBytes / 1048576.0 << " MB of disk in " << mappedDirectory();
+			*log << ", about " << setprecision(4) << seconds << "s per build and search pass"
+					<< (fits ? "" : " (over the cap)") << (onDisk ? "" : " (over the free disk space)") << endl;
+		}
+	}
+	if(log != NULL){
+		*log << "Plan: using " << storageName(chosen) << " distances under a cap of " << fixed << setprecision(1)
+				<< maxBytes / 1048576.0 << " MB" << (found ? "" : ", although nothing fits") << endl;
+	}
+	return chosen;
+}
+
+size_t Planner::getCacheBytes(){
+	return cacheBytes;
+}
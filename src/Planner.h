@@ -0,0 +1,54 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef PLANNER_H_
+#define PLANNER_H_
+
+#include <cstddef>
+#include <iostream>
+#include "DistanceMatrix.h"
+
+using namespace std;
+
+// Estimates, before anything large is allocated, the memory footprint and a
+// rough time cost of every distance storage for an instance, and picks the
+// fastest storage that fits a memory cap. The mapped storage counts its row
+// cache as memory and must also fit the free space of its directory.
+class Planner {
+public:
+	Planner(int _nPoints, int _nDimensions, int _nClusters, bool _multilevel);
+
+	// Peak bytes of a run: dataset, distances, solutions and, for the
+	// multilevel mode, the neighbour lists and the coarse levels.
+	size_t estimateBytes(DistanceStorage storage);
+	// Seconds to build the distances plus one full pass of the swap local search.
+	double estimateSeconds(DistanceStorage storage);
+
+	// Fastest storage whose footprint fits maxBytes (0 = 80% of the physical
+	// memory), or the smallest one when none fits. Writes every option and
+	// the decision to log unless it is NULL.
+	DistanceStorage choose(size_t maxBytes, ostream* log);
+	// Row cache of the mapped storage assumed by the last choose: the size
+	// set with setMappedStorage, or else what maxBytes leaves, at most the
+	// whole file.
+	size_t getCacheBytes();
+
+	static size_t physicalMemory();
+
+private:
+	double buildSeconds(DistanceStorage storage);
+	double passSeconds(DistanceStorage storage);
+
+	size_t nPoints;
+	size_t nDimensions;
+	size_t nClusters;
+	bool multilevel;
+	size_t cacheBytes;
+};
+#endif /* PLANNER_H_ */
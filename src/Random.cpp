@@ -2,15 +2,61 @@
 
 using namespace std;
 
-Random::Random(int _seed) {
+bool parseRandomEngine(const string& name, RandomEngine& engine){
+	if(name == "xoshiro") engine = RANDOM_XOSHIRO;
+	else if(name == "parkmiller") engine = RANDOM_PARKMILLER;
+	else return false;
+	return true;
+}
+
+Random::Random(int _seed, RandomEngine _engine) {
+	engine = _engine;
 	seed = _seed;
 	randp();
+
+	// The xoshiro state is expanded from the seed with splitmix64
+	uint64_t x = (uint64_t)(int64_t)_seed;
+	for(int i=0; i<4; i++){
+		x += 0x9e3779b97f4a7c15ULL;
+		uint64_t z = x;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		state[i] = z ^ (z >> 31);
+	}
 }
 
 double Random::getSeed(){
 	return seed;
 }
 
+RandomEngine Random::getEngine(){
+	return engine;
+}
+
+void Random::jump(){
+	static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+	uint64_t s[4] = { 0, 0, 0, 0 };
+	for(int i=0; i<4; i++){
+		for(int b=0; b<64; b++){
+			if(JUMP[i] & ((uint64_t)1 << b)){
+				for(int w=0; w<4; w++) s[w] ^= state[w];
+			}
+			next64();
+		}
+	}
+	for(int w=0; w<4; w++) state[w] = s[w];
+}
+
+Random Random::split(){
+	if(engine == RANDOM_PARKMILLER){
+		return Random(get_rand(2147483646), engine);
+	}
+	Random child(*this);
+	jump();
+	return child;
+}
+
 double Random::randp(){
 	int	xhi, xalo, leftlo, fhi, k;
 
@@ -50,7 +96,7 @@ double Random::randp(){
  Input: integers "seed", "i" and "j" in [1,2147483646]     *
  Ouput: integer in [i,j]                                   *
 ************************************************************/
-int Random::get_rand_ij(int i, int j ){
+int Random::get_rand_ij_pm(int i, int j ){
 
    randp();
 
@@ -63,13 +109,14 @@ int Random::get_rand_ij(int i, int j ){
  Input: integers "seed" and "size" in [1,2147483646]          *
  Ouput: integer in [1,size]                                   *
 **************************************************************/
-int Random::get_rand(int size){
+int Random::get_rand_pm(int size){
    randp();
    return ((double)seed/((double)2147483647/((double)size)))+1;
 
 }
 
 double Random::get_rand01(){
+   if(engine == RANDOM_XOSHIRO) return (next64() >> 11) * (1.0 / 9007199254740992.0);
    randp();
    return (double)seed/(double)2147483647;
 
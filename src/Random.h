@@ -2,20 +2,77 @@
 #define RANDOM_H_
 
 #include <random>
+#include <string>
+#include <stdint.h>
 
 using namespace std;
 
+enum RandomEngine {
+	RANDOM_XOSHIRO,    // xoshiro256**, the default
+	RANDOM_PARKMILLER  // the original minimal standard generator, for reproducing old runs
+};
+
+// Converts "xoshiro" or "parkmiller"; returns false for other names.
+bool parseRandomEngine(const string& name, RandomEngine& engine);
+
 class Random {
 
 private:
-	double seed;
+	RandomEngine engine;
+	double seed;        // Park-Miller state
+	uint64_t state[4];  // xoshiro256** state
+
+	static inline uint64_t rotl(uint64_t x, int k){
+		return (x << k) | (x >> (64 - k));
+	}
+
+	inline uint64_t next64(){
+		uint64_t result = rotl(state[1] * 5, 7) * 9;
+		uint64_t t = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = rotl(state[3], 45);
+		return result;
+	}
+
+	// Unbiased integer in [0, range) by Lemire's multiply-and-reject.
+	inline uint32_t bounded(uint32_t range){
+		uint64_t m = (next64() >> 32) * range;
+		uint32_t low = (uint32_t)m;
+		if(low < range){
+			uint32_t threshold = -range % range;
+			while(low < threshold){
+				m = (next64() >> 32) * range;
+				low = (uint32_t)m;
+			}
+		}
+		return m >> 32;
+	}
 
 public:
-	Random(int _seed);
+	Random(int _seed, RandomEngine _engine = RANDOM_XOSHIRO);
 	double getSeed();
+	RandomEngine getEngine();
+
+	// Advances the xoshiro stream by 2^128 draws, so that successive jumps
+	// give non-overlapping streams. No effect with Park-Miller.
+	void jump();
+	// Returns a generator for an independent stream and moves this one past
+	// it: the child takes the current stream and this generator jumps. With
+	// Park-Miller the child is seeded from a draw of this generator instead.
+	Random split();
 
-	int get_rand_ij(int i, int j );
-	int get_rand(int size );
+	inline int get_rand_ij(int i, int j ){
+		if(engine == RANDOM_PARKMILLER) return get_rand_ij_pm(i, j);
+		return i + (int)bounded((uint32_t)(j - i + 1));
+	}
+	inline int get_rand(int size ){
+		if(engine == RANDOM_PARKMILLER) return get_rand_pm(size);
+		return 1 + (int)bounded((uint32_t)size);
+	}
 	double get_rand01();
 	double randp();
 	int trand();
@@ -33,6 +90,9 @@ public:
 	    }
 	}
 
+private:
+	int get_rand_ij_pm(int i, int j);
+	int get_rand_pm(int size);
 };
 
 #endif /* RANDOM_H_ */
@@ -0,0 +1,132 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "ShakeController.h"
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+
+using namespace std;
+
+// Forgetting factor of the success history, applied at every report.
+static const double HISTORY_DECAY = 0.95;
+
+// Seconds added to every level's time so that cheap levels do not dominate
+// before they have a track record.
+static const double HISTORY_TIME_PRIOR = 1e-3;
+
+bool parseShakePolicy(const string& name, ShakePolicy& policy){
+	if(name == "cyclic") policy = SHAKE_CYCLIC;
+	else if(name == "bandit") policy = SHAKE_BANDIT;
+	else if(name == "history") policy = SHAKE_HISTORY;
+	else return false;
+	return true;
+}
+
+ShakeController::ShakeController(ShakePolicy _policy, int kMin, int kStep, int kMax, Random* _random){
+	policy = _policy;
+	random = _random;
+	current = 0;
+	totalTries = 0;
+
+	// A non-positive step keeps k at kMin, as the basic VNS loop does
+	int k = kMin;
+	do{
+		Level level;
+		level.k = k;
+		level.tries = 0;
+		level.successes = 0;
+		level.gain = 0.0;
+		level.seconds = 0.0;
+		level.weight = 1.0;
+		levels.push_back(level);
+		k += kStep;
+	}while(kStep > 0 && k <= kMax);
+}
+
+int ShakeController::next(){
+	if(policy == SHAKE_BANDIT) current = selectBandit();
+	else if(policy == SHAKE_HISTORY) current = selectHistory();
+	return levels[current].k;
+}
+
+void ShakeController::report(double gain, double bestValue, double seconds){
+	Level& level = levels[current];
+	bool improved = gain > 0;
+	double relativeGain = improved && bestValue > 0 ? gain / bestValue : 0.0;
+
+	level.tries++;
+	level.seconds += seconds;
+	totalTries++;
+	if(improved){
+		level.successes++;
+		level.gain += relativeGain;
+	}
+
+	if(policy == SHAKE_CYCLIC){
+		current = improved || current + 1 == (int)levels.size() ? 0 : current + 1;
+	}else if(policy == SHAKE_HISTORY){
+		for(size_t l=0; l<levels.size(); l++){
+			levels[l].weight *= HISTORY_DECAY;
+		}
+		level.weight += improved ? 1.0 : 0.0;
+	}
+}
+
+// UCB1 on the relative gain per second of every level. Untried levels go
+// first; the exploration term is scaled by the best observed rate.
+int ShakeController::selectBandit(){
+	double bestRate = 0.0;
+	for(size_t l=0; l<levels.size(); l++){
+		if(levels[l].tries == 0) return l;
+		bestRate = max(bestRate, levels[l].gain / max(levels[l].seconds, HISTORY_TIME_PRIOR));
+	}
+	if(bestRate <= 0) bestRate = 1.0;
+
+	int best = 0;
+	double bestScore = -1.0;
+	for(size_t l=0; l<levels.size(); l++){
+		double rate = levels[l].gain / max(levels[l].seconds, HISTORY_TIME_PRIOR);
+		double score = rate + bestRate * sqrt(2.0 * log((double)totalTries) / levels[l].tries);
+		if(score > bestScore){
+			bestScore = score;
+			best = l;
+		}
+	}
+	return best;
+}
+
+// Roulette wheel on decayed successes per average second of each level.
+int ShakeController::selectHistory(){
+	vector<double> score(levels.size());
+	double total = 0.0;
+	for(size_t l=0; l<levels.size(); l++){
+		double secondsPerTry = (levels[l].seconds + HISTORY_TIME_PRIOR) / (levels[l].tries + 1);
+		score[l] = (levels[l].weight + 0.05) / secondsPerTry;
+		total += score[l];
+	}
+	double target = random->get_rand01() * total;
+	for(size_t l=0; l<levels.size(); l++){
+		target -= score[l];
+		if(target <= 0) return l;
+	}
+	return levels.size() - 1;
+}
+
+void ShakeController::print(ostream& out){
+	out << "k,tries,improvements,relative gain,seconds,gain per second" << endl;
+	for(size_t l=0; l<levels.size(); l++){
+		const Level& level = levels[l];
+		if(level.tries == 0) continue;
+		out << level.k << "," << level.tries << "," << level.successes;
+		out << "," << setprecision(4) << scientific << level.gain;
+		out << "," << setprecision(4) << fixed << level.seconds;
+		out << "," << setprecision(4) << scientific << (level.seconds > 0 ? level.gain / level.seconds : 0.0) << endl;
+	}
+}
@@ -0,0 +1,62 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef SHAKECONTROLLER_H_
+#define SHAKECONTROLLER_H_
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include "Random.h"
+
+using namespace std;
+
+enum ShakePolicy {
+	SHAKE_CYCLIC,  // basic VNS: reset to kMin on improvement, else kStep up and wrap
+	SHAKE_BANDIT,  // UCB1 over the k levels, rewarded by relative gain per second
+	SHAKE_HISTORY  // roulette over the k levels weighted by decayed success per second
+};
+
+// Converts "cyclic", "bandit" or "history"; returns false for other names.
+bool parseShakePolicy(const string& name, ShakePolicy& policy);
+
+// Chooses the shaking strength k of every VNS iteration among the levels
+// kMin, kMin+kStep, ..., kMax, and records for each level how often it was
+// tried, how often it led to a new best solution, the gain it brought and
+// the time spent in its shakes and local searches.
+class ShakeController {
+public:
+	ShakeController(ShakePolicy _policy, int kMin, int kStep, int kMax, Random* _random);
+
+	int next();
+	// Outcome of the last k returned by next(): gain is the decrease of the
+	// best value (0 if none) and seconds the time the iteration took.
+	void report(double gain, double bestValue, double seconds);
+	void print(ostream& out);
+
+private:
+	struct Level {
+		int k;
+		int tries;
+		int successes;
+		double gain;      // sum of relative gains
+		double seconds;
+		double weight;    // decayed success rate used by SHAKE_HISTORY
+	};
+
+	ShakePolicy policy;
+	Random* random;
+	vector<Level> levels;
+	int current;
+	int totalTries;
+
+	int selectBandit();
+	int selectHistory();
+};
+#endif /* SHAKECONTROLLER_H_ */
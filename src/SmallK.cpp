@@ -0,0 +1,95 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "SmallK.h"
+#include "Solution.h"
+#include <vector>
+#include <stdint.h>
+
+using namespace std;
+
+// K is the cluster count, or 0 when it is only known at run time.
+template<int K, typename Label>
+static void initializeScKernel(Solution& solution){
+	int n = solution.nDataPoints;
+	int k = K > 0 ? K : solution.nClusters;
+	double** sc = solution.sc;
+
+	vector<Label> label(n);
+	for(int i=0; i<n; i++){
+		label[i] = (Label)solution.assignment[i];
+		for(int c=0; c<k; c++) sc[i][c] = 0.0;
+	}
+
+	// Each distance of the lower triangle is read once and added to both ends
+	double fixedRow[K > 0 ? K : 1];
+	vector<double> dynamicRow(K > 0 ? 0 : k);
+	double* row = K > 0 ? fixedRow : &dynamicRow[0];
+	vector<double> buffer(n);
+	for(int i=0; i<n; i++){
+		if(i + 1 < n) solution.distances->prefetchRow(i + 1);
+		const double* distance = solution.distances->getRow(i, &buffer[0]);
+		Label labelI = label[i];
+		for(int c=0; c<k; c++) row[c] = sc[i][c];
+		for(int j=0; j<i; j++){
+			double d = distance[j];
+			row[label[j]] += d;
+			sc[j][labelI] += d;
+		}
+		for(int c=0; c<k; c++) sc[i][c] = row[c];
+	}
+}
+
+template<int K>
+static double evaluateKernel(Solution& solution){
+	int k = K > 0 ? K : solution.nClusters;
+	double fixedSum[K > 0 ? K : 1];
+	vector<double> dynamicSum(K > 0 ? 0 : k);
+	double* intraClusterSum = K > 0 ? fixedSum : &dynamicSum[0];
+	for(int c=0; c<k; c++) intraClusterSum[c] = 0.0;
+
+	for(int i=0; i<solution.nDataPoints; i++){
+		intraClusterSum[solution.assignment[i]] += solution.sc[i][solution.assignment[i]];
+	}
+
+	// Each pair distance is counted twice in sc, so divide by 2
+	double value = 0.0;
+	for(int c=0; c<k; c++){
+		if(solution.clusterSizes[c] > 0){
+			value += (intraClusterSum[c] / 2.0) / solution.clusterSizes[c];
+		}
+	}
+	return value;
+}
+
+template<int K>
+static SolutionKernels kernelsFor(){
+	SolutionKernels kernels;
+	kernels.initializeSc = initializeScKernel<K, uint8_t>;
+	kernels.evaluate = evaluateKernel<K>;
+	return kernels;
+}
+
+static const SolutionKernels SMALL_KERNELS[SMALLK_MAX + 1] = {
+	kernelsFor<0>(), kernelsFor<0>(), kernelsFor<2>(), kernelsFor<3>(),
+	kernelsFor<4>(), kernelsFor<5>(), kernelsFor<6>(), kernelsFor<7>(),
+	kernelsFor<8>(), kernelsFor<9>(), kernelsFor<10>(), kernelsFor<11>(),
+	kernelsFor<12>(), kernelsFor<13>(), kernelsFor<14>(), kernelsFor<15>()
+};
+
+SolutionKernels selectKernels(int nClusters){
+	if(nClusters >= 0 && nClusters <= SMALLK_MAX) return SMALL_KERNELS[nClusters];
+
+	SolutionKernels kernels;
+	kernels.evaluate = evaluateKernel<0>;
+	if(nClusters <= 256) kernels.initializeSc = initializeScKernel<0, uint8_t>;
+	else if(nClusters <= 65536) kernels.initializeSc = initializeScKernel<0, uint16_t>;
+	else kernels.initializeSc = initializeScKernel<0, int>;
+	return kernels;
+}
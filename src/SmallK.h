@@ -0,0 +1,33 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef SMALLK_H_
+#define SMALLK_H_
+
+class Solution;
+
+// Kernels over all points and clusters of a solution, compiled once per
+// cluster count from 2 to SMALLK_MAX so that the per-cluster accumulators
+// stay in registers and the cluster loops are unrolled, with a generic
+// version for other counts. Cluster labels are read from a compact copy of
+// the assignment (uint8_t up to 256 clusters, uint16_t up to 65536).
+typedef void (*ScKernel)(Solution& solution);
+typedef double (*EvaluateKernel)(Solution& solution);
+
+const int SMALLK_MAX = 15;
+
+struct SolutionKernels {
+	ScKernel initializeSc;      // rebuilds sc from the assignment
+	EvaluateKernel evaluate;    // objective value from sc
+};
+
+// Looks up the kernels for nClusters in the dispatch table.
+SolutionKernels selectKernels(int nClusters);
+
+#endif /* SMALLK_H_ */
@@ -11,6 +11,8 @@
 #include "DistanceMatrix.h"
 #include <vector>
 #include <iostream>
+#include <float.h>
+#include <algorithm>
 
 using namespace std;
 
@@ -22,37 +24,40 @@ Solution::Solution(int _nClusters, int _nDataPoints, DistanceMatrix* _distances)
 	nClusters = _nClusters;
 	nDataPoints = _nDataPoints;
 	distances =  _distances;
+	capacity = nDataPoints;
 	solutionValue = 0;
 	time = 0.0;
 
 	assignment = new int[nDataPoints];
 	clusterSizes = new double[nClusters];
 
-	sc = new double*[nDataPoints];
-	for(int i = 0; i<nDataPoints; i++){
-		sc[i] = new double[nClusters];
-	}
+	allocateSc();
 
 	for(int i=0; i<nClusters; i++){
 		clusterSizes[i] = 0;
 	}
 
+	members.resize(nClusters);
+	position.resize(nDataPoints);
+	clusterHash.assign(nClusters, 0);
+	hash = 0;
+	kernels = selectKernels(nClusters);
 }
 
 Solution::Solution(const Solution& copy){
 	distances = copy.distances;
 	nClusters = copy.nClusters;
 	nDataPoints = copy.nDataPoints;
+	capacity = nDataPoints;
 	time = copy.time;
 	solutionValue = copy.solutionValue;
 
 	assignment = new int[nDataPoints];
 	clusterSizes = new double[nClusters];
 
-	sc = new double*[nDataPoints];
+	allocateSc();
 	for(int i=0; i<nDataPoints; i++){
 		assignment[i] = copy.assignment[i];
-		sc[i] = new double[nClusters];
 		for(int j=0; j<nClusters; j++){
 			sc[i][j] = copy.sc[i][j];
 		}
@@ -61,12 +66,24 @@ Solution::Solution(const Solution& copy){
 	for(int i=0; i<nClusters; i++){
 		clusterSizes[i]=copy.clusterSizes[i];
 	}
+
+	members = copy.members;
+	position = copy.position;
+	clusterHash = copy.clusterHash;
+	hash = copy.hash;
+	kernels = copy.kernels;
 }
 
-Solution::~Solution(){
-	for(int i=0; i<nDataPoints; i++){
-		delete [] sc[i];
+void Solution::allocateSc(){
+	scStorage = allocateBlock(sizeof(double) * (size_t)capacity * nClusters);
+	sc = new double*[capacity];
+	for(int i=0; i<capacity; i++){
+		sc[i] = (double*)scStorage.data + (size_t)i*nClusters;
 	}
+}
+
+Solution::~Solution(){
+	releaseBlock(scStorage);
 	delete [] sc;
 	delete [] assignment;
 	delete [] clusterSizes;
@@ -89,32 +106,233 @@ void Solution::copy(const Solution& copy){
 	for(int i=0; i<nClusters; i++){
 		clusterSizes[i]=copy.clusterSizes[i];
 	}
+
+	members = copy.members;
+	position = copy.position;
+	clusterHash = copy.clusterHash;
+	hash = copy.hash;
+	kernels = copy.kernels;
 }
 
 void Solution::initializeSc(){
+	kernels.initializeSc(*this);
+	buildMembers();
+}
+
+void Solution::buildMembers(){
+	members.resize(nClusters);
+	position.resize(nDataPoints);
+	for(int c=0; c<nClusters; c++){
+		members[c].clear();
+	}
+	clusterHash.assign(nClusters, 0);
 	for(int i=0; i<nDataPoints; i++){
-		for(int j=0; j<nClusters; j++){
-			sc[i][j] = 0.0;
-		}
+		position[i] = members[assignment[i]].size();
+		members[assignment[i]].push_back(i);
+		clusterHash[assignment[i]] ^= pointKey(i);
 	}
+	rebuildHash();
+}
 
-	for(int i=0; i<nDataPoints; i++){
-		for(int j=0; j<nDataPoints; j++){
-			sc[i][assignment[j]] += distances->getDistance(i,j);
-		}
+void Solution::rebuildHash(){
+	hash = 0;
+	for(int c=0; c<nClusters; c++){
+		hash += mixHash(clusterHash[c]);
 	}
 }
 
+void Solution::swapPoints(int pointI, int pointJ){
+	int clusterI = assignment[pointI];
+	int clusterJ = assignment[pointJ];
+	hash -= mixHash(clusterHash[clusterI]) + mixHash(clusterHash[clusterJ]);
+	exchangePoints(pointI, pointJ);
+	hash += mixHash(clusterHash[clusterI]) + mixHash(clusterHash[clusterJ]);
+}
 
+void Solution::exchangePoints(int pointI, int pointJ){
+	int clusterI = assignment[pointI];
+	int clusterJ = assignment[pointJ];
+	members[clusterI][position[pointI]] = pointJ;
+	members[clusterJ][position[pointJ]] = pointI;
+	int positionI = position[pointI];
+	position[pointI] = position[pointJ];
+	position[pointJ] = positionI;
+	assignment[pointI] = clusterJ;
+	assignment[pointJ] = clusterI;
+
+	uint64_t keys = pointKey(pointI) ^ pointKey(pointJ);
+	clusterHash[clusterI] ^= keys;
+	clusterHash[clusterJ] ^= keys;
+}
 
+void Solution::movePoint(int point, int cluster){
+	int from = assignment[point];
+	int last = members[from].back();
+	members[from][position[point]] = last;
+	position[last] = position[point];
+	members[from].pop_back();
+
+	position[point] = members[cluster].size();
+	members[cluster].push_back(point);
+	assignment[point] = cluster;
+	clusterSizes[from]--;
+	clusterSizes[cluster]++;
+
+	uint64_t key = pointKey(point);
+	hash -= mixHash(clusterHash[from]) + mixHash(clusterHash[cluster]);
+	clusterHash[from] ^= key;
+	clusterHash[cluster] ^= key;
+	hash += mixHash(clusterHash[from]) + mixHash(clusterHash[cluster]);
+}
 
+void Solution::placePoint(int point, int cluster){
+	position[point] = members[cluster].size();
+	members[cluster].push_back(point);
+	assignment[point] = cluster;
+	clusterSizes[cluster]++;
 
+	hash -= mixHash(clusterHash[cluster]);
+	clusterHash[cluster] ^= pointKey(point);
+	hash += mixHash(clusterHash[cluster]);
+}
+
+void Solution::unplacePoint(int point){
+	int from = assignment[point];
+	int last = members[from].back();
+	members[from][position[point]] = last;
+	position[last] = position[point];
+	members[from].pop_back();
+	assignment[point] = -1;
+	clusterSizes[from]--;
+
+	hash -= mixHash(clusterHash[from]);
+	clusterHash[from] ^= pointKey(point);
+	hash += mixHash(clusterHash[from]);
+}
 
+void Solution::removePoint(int point){
+	if(assignment[point] >= 0){
+		int from = assignment[point];
+		distances->useRow(point);
+		for(int k=0; k<nDataPoints; k++){
+			sc[k][from] -= distances->getDistance(point, k);
+		}
+		unplacePoint(point);
+	}
 
+	// The last point takes the index of the removed one, and its hash key with it
+	int last = nDataPoints - 1;
+	if(point != last){
+		int c = assignment[last];
+		if(c >= 0){
+			members[c][position[last]] = point;
+			position[point] = position[last];
+			hash -= mixHash(clusterHash[c]);
+			clusterHash[c] ^= pointKey(last) ^ pointKey(point);
+			hash += mixHash(clusterHash[c]);
+		}
+		assignment[point] = c;
+		for(int j=0; j<nClusters; j++){
+			sc[point][j] = sc[last][j];
+		}
+	}
+	resize(last);
+}
 
+void Solution::resize(int newSize){
+	if(newSize > capacity){
+		int* oldAssignment = assignment;
+		double** oldSc = sc;
+		MemoryBlock oldStorage = scStorage;
+		capacity = max(newSize, 2*capacity);
+		assignment = new int[capacity];
+		allocateSc();
+		for(int i=0; i<nDataPoints; i++){
+			assignment[i] = oldAssignment[i];
+			for(int c=0; c<nClusters; c++){
+				sc[i][c] = oldSc[i][c];
+			}
+		}
+		releaseBlock(oldStorage);
+		delete [] oldSc;
+		delete [] oldAssignment;
+	}
+	for(int i=nDataPoints; i<newSize; i++){
+		assignment[i] = -1;
+		for(int c=0; c<nClusters; c++){
+			sc[i][c] = 0.0;
+		}
+	}
+	nDataPoints = newSize;
+	position.resize(nDataPoints);
+}
 
+void Solution::evaluate(){
+	solutionValue = kernels.evaluate(*this);
+}
 
+int Solution::targetSize(int c){
+	return nDataPoints/nClusters + (c < nDataPoints%nClusters ? 1 : 0);
+}
 
+void Solution::balancedTargets(vector<int>& targets){
+	vector<int> order(nClusters);
+	for(int c=0; c<nClusters; c++) order[c] = c;
+	stable_sort(order.begin(), order.end(), [this](int a, int b){
+		return clusterSizes[a] > clusterSizes[b];
+	});
+	targets.resize(nClusters);
+	for(int r=0; r<nClusters; r++){
+		targets[order[r]] = nDataPoints/nClusters + (r < nDataPoints%nClusters ? 1 : 0);
+	}
+}
 
+int Solution::rebalance(){
+	vector<int> targets;
+	balancedTargets(targets);
+	vector<double> pairSum(nClusters, 0.0);
+	for(int i=0; i<nDataPoints; i++){
+		pairSum[assignment[i]] += sc[i][assignment[i]] / 2.0;
+	}
 
+	int moves = 0;
+	while(true){
+		// Cost of taking point i out of its cluster and putting it into c,
+		// using W/|C| as the cost of a cluster with pair sum W.
+		double bestCost = DBL_MAX;
+		int bestPoint = -1, bestCluster = -1;
+		for(int i=0; i<nDataPoints; i++){
+			int from = assignment[i];
+			if(clusterSizes[from] <= targets[from]) continue;
+
+			double removal = (pairSum[from] - sc[i][from]) / (clusterSizes[from] - 1) - pairSum[from] / clusterSizes[from];
+			for(int c=0; c<nClusters; c++){
+				if(clusterSizes[c] >= targets[c]) continue;
+
+				double before = clusterSizes[c] > 0 ? pairSum[c] / clusterSizes[c] : 0.0;
+				double cost = removal + (pairSum[c] + sc[i][c]) / (clusterSizes[c] + 1) - before;
+				if(cost < bestCost){
+					bestCost = cost;
+					bestPoint = i;
+					bestCluster = c;
+				}
+			}
+		}
+		if(bestPoint == -1) break;
+
+		int from = assignment[bestPoint];
+		pairSum[from] -= sc[bestPoint][from];
+		pairSum[bestCluster] += sc[bestPoint][bestCluster];
+		distances->useRow(bestPoint);
+		for(int k=0; k<nDataPoints; k++){
+			double dist = distances->getDistance(bestPoint, k);
+			sc[k][from] -= dist;
+			sc[k][bestCluster] += dist;
+		}
+		movePoint(bestPoint, bestCluster);
+		moves++;
+	}
 
+	evaluate();
+	return moves;
+}
@@ -11,8 +11,11 @@
 #define SOLUTION_H_
 
 #include <vector>
+#include <stdint.h>
 #include "DistanceMatrix.h"
 #include "Point.h"
+#include "SmallK.h"
+#include "Memory.h"
 
 using namespace std;
 
@@ -21,21 +24,91 @@ public:
 
 	int nClusters;
 	int nDataPoints;
+	int capacity;      // points assignment and sc have room for
 	double solutionValue;
 	double time;
 
 	DistanceMatrix* distances;
 
 	double** sc;
+	MemoryBlock scStorage;   // the rows of sc, one after the other
 
 	int* assignment;
 	double* clusterSizes;
 
+	// Points of each cluster, in no particular order, and the index of every
+	// point in the list of its cluster. Kept in step with assignment by
+	// swapPoints and movePoint, and rebuilt by initializeSc.
+	vector< vector<int> > members;
+	vector<int> position;
+
+	// Zobrist hash of the partition, independent of the cluster labels:
+	// clusterHash[c] is the XOR of the keys of the points of c and hash the
+	// sum of mixHash over the clusters. Kept in step by swapPoints and
+	// movePoint in O(1), and rebuilt with members.
+	vector<uint64_t> clusterHash;
+	uint64_t hash;
+
+	// initializeSc and evaluate, specialized for the number of clusters.
+	SolutionKernels kernels;
+
 	Solution();
 	Solution(const Solution& copy);
 	Solution(int _nClusters, int _nDataPoints, DistanceMatrix* _distances);
 	~Solution();
+	// Copies copy into this solution, which must have the same dimensions.
 	void copy(const Solution& copy);
 	void initializeSc();
+	// Rebuilds members, position and the hashes from assignment in O(n).
+	void buildMembers();
+	// Exchanges the clusters of two points in assignment and members, in O(1).
+	void swapPoints(int pointI, int pointJ);
+	// swapPoints without the update of hash, which is shared by all clusters:
+	// exchanges within disjoint pairs of clusters can run concurrently, and
+	// rebuildHash then restores hash in O(k).
+	void exchangePoints(int pointI, int pointJ);
+	void rebuildHash();
+	// Moves a point to another cluster in assignment, members and clusterSizes, in O(1).
+	void movePoint(int point, int cluster);
+	// Puts an unassigned point (cluster -1) into a cluster, in O(1).
+	void placePoint(int point, int cluster);
+	// Takes a point out of its cluster, leaving it unassigned, in O(1).
+	void unplacePoint(int point);
+	// Deletes a point, subtracting its distances from sc in O(n), and moves
+	// the last point into its index. Must be called before the point leaves
+	// the distance matrix (see DistanceMatrix::removePoint).
+	void removePoint(int point);
+	// Changes the number of points. New points are unassigned, with zero sc
+	// rows, and storage grows geometrically; points cut off must have been
+	// unassigned. sc is not updated.
+	void resize(int newSize);
+
+	// Random key of a point and the finalizer applied to every clusterHash
+	// (both from splitmix64), shared by all solutions.
+	static inline uint64_t pointKey(int point){
+		return mixHash((uint64_t)(point + 1) * 0x9E3779B97F4A7C15ULL);
+	}
+	static inline uint64_t mixHash(uint64_t x){
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return x ^ (x >> 31);
+	}
+
+	// Recomputes solutionValue from the sc matrix in O(n).
+	void evaluate();
+	// Size cluster c must have under the balance constraint.
+	int targetSize(int c);
+	// Balanced sizes closest to the current ones: the n%k largest clusters
+	// get n/k+1 points and the others n/k, so reaching them takes the fewest
+	// moves.
+	void balancedTargets(vector<int>& targets);
+	// Moves points out of oversized clusters until every cluster has its
+	// balanced target size, choosing the cheapest move each time. Expects sc
+	// to match the assignment and clusterSizes to hold the actual sizes.
+	// Returns the number of points moved.
+	int rebalance();
+
+private:
+	void allocateSc();
 };
 #endif /* SOLUTION_H_ */
@@ -0,0 +1,399 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "Solver.h"
+#include "Solution.h"
+#include "Random.h"
+#include "Vns.h"
+#include "OnlineInsertion.h"
+#include "Multilevel.h"
+#include "Planner.h"
+#include <sstream>
+#include <stdexcept>
+#include <cstdlib>
+#include <thread>
+
+using namespace std;
+
+SolverParams::SolverParams(){
+	nClusters = 2;
+	maxTime = 1.0;
+	seed = 1;
+	kMin = 2;
+	kStep = 0;
+	kMax = 0;
+	verbose = false;
+	wallClock = false;
+	threadClock = false;
+	multilevel = false;
+	coarsestSize = 1000;
+	construction = CONSTRUCTION_RANDOM;
+	polishPeriod = 0;
+	polishAfterShaking = false;
+	cyclicLength = 0;
+	pairDescent = false;
+	searchThreads = 1;
+	shakePolicy = SHAKE_CYCLIC;
+	eliteSize = 0;
+	relinkPeriod = 10;
+	visitedSize = 0;
+	rngEngine = RANDOM_XOSHIRO;
+	threads = 0;
+	hugePages = HUGEPAGES_TRANSPARENT;
+	cpuAuto = true;
+	cpuLevel = CPU_SSE2;
+	prefault = false;
+	storageAuto = true;
+	storage = STORAGE_DOUBLE;
+	memoryCap = 0;
+	cacheSize = 0;
+	validatePeriod = 0.0;
+	repairMoves = 2;
+	warmStart = false;
+	sweepTo = 0;
+}
+
+static bool parseInt(const string& value, int& out){
+	char* end;
+	long v = strtol(value.c_str(), &end, 10);
+	if(value.empty() || *end != '\0') return false;
+	out = (int)v;
+	return true;
+}
+
+static bool parseDouble(const string& value, double& out){
+	char* end;
+	double v = strtod(value.c_str(), &end);
+	if(value.empty() || *end != '\0') return false;
+	out = v;
+	return true;
+}
+
+static bool parseBool(const string& value, bool& out){
+	int v;
+	if(!parseInt(value, v)) return false;
+	out = v != 0;
+	return true;
+}
+
+bool SolverParams::set(const string& name, const string& value){
+	if(name == "k" || name == "clusters") return parseInt(value, nClusters);
+	if(name == "time") return parseDouble(value, maxTime);
+	if(name == "seed") return parseInt(value, seed);
+	if(name == "kmin") return parseInt(value, kMin);
+	if(name == "kstep") return parseInt(value, kStep);
+	if(name == "kmax") return parseInt(value, kMax);
+	if(name == "clock"){
+		if(value != "cpu" && value != "wall" && value != "thread") return false;
+		wallClock = value == "wall";
+		threadClock = value == "thread";
+		return true;
+	}
+	if(name == "verbose") return parseBool(value, verbose);
+	if(name == "multilevel") return parseBool(value, multilevel);
+	if(name == "coarsest") return parseInt(value, coarsestSize);
+	if(name == "init") return parseConstructionMethod(value, construction);
+	if(name == "polish") return parseInt(value, polishPeriod);
+	if(name == "polishshake") return parseBool(value, polishAfterShaking);
+	if(name == "cyclic") return parseInt(value, cyclicLength);
+	if(name == "descent"){
+		pairDescent = value == "pairs";
+		return pairDescent || value == "first";
+	}
+	if(name == "lsthreads") return parseInt(value, searchThreads) && searchThreads >= 0;
+	if(name == "shake") return parseShakePolicy(value, shakePolicy);
+	if(name == "elite") return parseInt(value, eliteSize) && eliteSize >= 0;
+	if(name == "relink") return parseInt(value, relinkPeriod) && relinkPeriod >= 0;
+	if(name == "visited") return parseInt(value, visitedSize) && visitedSize >= 0;
+	if(name == "rng") return parseRandomEngine(value, rngEngine);
+	if(name == "threads") return parseInt(value, threads) && threads >= 0;
+	if(name == "hugepages") return parseHugePagePolicy(value, hugePages);
+	if(name == "cpu"){
+		cpuAuto = value == "auto";
+		return cpuAuto || parseCpuLevel(value, cpuLevel);
+	}
+	if(name == "prefault") return parseBool(value, prefault);
+	if(name == "storage"){
+		storageAuto = value == "auto";
+		return storageAuto || parseDistanceStorage(value, storage);
+	}
+	if(name == "memory") return parseInt(value, memoryCap) && memoryCap >= 0;
+	if(name == "spill"){
+		spillDirectory = value;
+		return !value.empty();
+	}
+	if(name == "cache") return parseInt(value, cacheSize) && cacheSize >= 0;
+	if(name == "repair") return parseInt(value, repairMoves) && repairMoves >= 0;
+	if(name == "validate") return parseDouble(value, validatePeriod) && validatePeriod >= 0;
+	if(name == "sweep") return parseInt(value, sweepTo) && sweepTo >= 0;
+	return false;
+}
+
+bool SolverParams::parse(const string& options){
+	stringstream ss(options);
+	string token;
+	while(ss >> token){
+		size_t eq = token.find('=');
+		if(eq == string::npos || !set(token.substr(0, eq), token.substr(eq+1))){
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SolverParams::wallTime() const{
+	int nThreads = searchThreads > 0 ? searchThreads : thread::hardware_concurrency();
+	return wallClock || nThreads > 1;
+}
+
+void SolverParams::configure(Vns& vns) const{
+	vns.setVerbose(verbose);
+	vns.setConstruction(construction);
+	vns.setPolishing(polishPeriod, polishAfterShaking);
+	vns.setCyclicExchange(cyclicLength);
+	vns.setPairDescent(pairDescent);
+	vns.setSearchThreads(searchThreads);
+	vns.setShakePolicy(shakePolicy);
+	vns.setElitePool(eliteSize, relinkPeriod);
+	vns.setVisitedSet(visitedSize);
+	vns.setWarmStart(warmStart);
+}
+
+int Solver::run(const SolverParams& params, Solution& solution, DistanceMatrix* distances,
+		vector< vector<Pair> >* rankedEntities, Random* random,
+		function<void(int, double, double, int)> progress, function<bool()> cancel){
+	// Checks run on their own thread, so the search then measures the CPU
+	// time of its thread rather than of the process
+	Validator* validator = params.validatePeriod > 0 ? new Validator(params.validatePeriod, cerr) : NULL;
+	int iterations;
+
+	if(params.multilevel){
+		Multilevel multilevelSearch(distances, rankedEntities, random, params);
+		multilevelSearch.setProgressCallback(progress);
+		multilevelSearch.setCancelCallback(cancel);
+		multilevelSearch.setValidator(validator);
+		iterations = multilevelSearch.execute(solution, params.maxTime, params.kMin, params.kStep, params.kMax);
+	}else{
+		Vns vns(NULL, distances, params.nClusters, random, rankedEntities);
+		params.configure(vns);
+		ChronoReal wallTimer;
+		ChronoThread threadTimer;
+		if(params.wallTime()){
+			vns.setTimer(&wallTimer);
+		}else if(validator || params.threadClock){
+			vns.setTimer(&threadTimer);
+		}
+		vns.setProgressCallback(progress);
+		vns.setCancelCallback(cancel);
+		vns.setValidator(validator);
+		iterations = vns.execute(solution, params.maxTime, params.kMin, params.kStep, params.kMax, "");
+	}
+
+	if(validator){
+		validator->stop();
+		if(params.verbose){
+			cout << "Validator: " << validator->getChecks() << " checks, " << validator->getProblems() << " problems" << endl;
+		}
+		delete validator;
+	}
+	return iterations;
+}
+
+Solver::Solver(const double* _coordinates, int _nPoints, int _nDimensions){
+	coordinates.assign(_coordinates, _coordinates + (size_t)_nPoints*_nDimensions);
+	nPoints = _nPoints;
+	nDimensions = _nDimensions;
+	distances = NULL;
+	ownsDistances = true;
+	rankedEntities = &ownedRankedEntities;
+	solution = NULL;
+}
+
+Solver::Solver(const double* distanceMatrix, int _nPoints){
+	distances = new DistanceMatrix(distanceMatrix, _nPoints);
+	nPoints = _nPoints;
+	nDimensions = 0;
+	ownsDistances = true;
+	rankedEntities = &ownedRankedEntities;
+	solution = NULL;
+}
+
+Solver::Solver(DistanceMatrix* _distances, vector< vector<Pair> >* _rankedEntities){
+	distances = _distances;
+	nPoints = distances->getSize();
+	nDimensions = 0;
+	ownsDistances = false;
+	rankedEntities = _rankedEntities;
+	solution = NULL;
+}
+
+Solver::~Solver(){
+	delete solution;
+	if(ownsDistances){
+		delete distances;
+	}
+}
+
+void Solver::setProgressCallback(function<void(const SolverProgress&)> callback){
+	progressCallback = callback;
+}
+
+void Solver::setCancelCallback(function<bool()> callback){
+	cancelCallback = callback;
+}
+
+int Solver::getNumberOfPoints(){
+	return distances != NULL ? distances->getSize() : nPoints;
+}
+
+void Solver::prepareDistances(const SolverParams& params){
+	if(distances != NULL && (!ownsDistances || !distances->hasCoordinates())){
+		if(!params.storageAuto && params.storage != distances->getStorage()){
+			throw invalid_argument("storage= only applies to instances built from coordinates by this solver");
+		}
+		if(params.memoryCap > 0){
+			throw invalid_argument("memory= only applies to instances built from coordinates by this solver");
+		}
+		return;
+	}
+
+	int n = getNumberOfPoints();
+	int d = distances != NULL ? distances->getDimensions() : nDimensions;
+	DistanceStorage storage = params.storage;
+	size_t cacheBytes = (size_t)params.cacheSize << 20;
+	if(params.storageAuto){
+		Planner planner(n, d, params.nClusters, params.multilevel);
+		storage = planner.choose((size_t)params.memoryCap << 20, params.verbose ? &cout : NULL);
+		if(storage == STORAGE_MAPPED && cacheBytes == 0) cacheBytes = planner.getCacheBytes();
+	}
+	if(distances != NULL && distances->getStorage() == storage) return;
+
+	// Distances do not depend on the centring, so the matrix's own
+	// coordinates rebuild it
+	const double* points = distances != NULL ? distances->getCoordinates() : coordinates.data();
+	DistanceMatrix* built = new DistanceMatrix(points, n, d, params.threads, storage, cacheBytes);
+	delete distances;
+	distances = built;
+	vector<double>().swap(coordinates);
+}
+
+SolverResult Solver::solve(const SolverParams& params, int* assignment){
+	int n = getNumberOfPoints();
+	if(params.nClusters < 1 || params.nClusters > n){
+		throw invalid_argument("number of clusters must be between 1 and the number of points");
+	}
+	if(params.maxTime < 0){
+		throw invalid_argument("time limit must not be negative");
+	}
+
+	delete solution;
+	solution = NULL;
+	prepareDistances(params);
+	solution = new Solution(params.nClusters, n, distances);
+	return search(params, assignment);
+}
+
+// Runs the search on solution and copies the result out.
+SolverResult Solver::search(const SolverParams& params, int* assignment){
+	int n = solution->nDataPoints;
+	int kMax = params.kMax > 0 ? params.kMax : n/2;
+	int kStep = params.kStep > 0 ? params.kStep : kMax/20;
+
+	bool cancelled = false;
+	function<bool()> cancel;
+	if(cancelCallback){
+		function<bool()> callback = cancelCallback;
+		cancel = [&cancelled, callback]() {
+			if(!cancelled && callback()) cancelled = true;
+			return cancelled;
+		};
+	}
+	function<void(int, double, double, int)> progress;
+	if(progressCallback){
+		function<void(const SolverProgress&)> callback = progressCallback;
+		progress = [callback](int iteration, double value, double time, int k) {
+			SolverProgress p;
+			p.iteration = iteration;
+			p.solutionValue = value;
+			p.time = time;
+			p.k = k;
+			callback(p);
+		};
+	}
+
+	SolverParams runParams = params;
+	runParams.kMax = kMax;
+	runParams.kStep = kStep;
+	Random random(params.seed, params.rngEngine);
+	SolverResult result;
+	result.nIterations = run(runParams, *solution, distances, rankedEntities, &random, progress, cancel);
+	result.solutionValue = solution->solutionValue;
+	result.time = solution->time;
+	result.cancelled = cancelled;
+
+	for(int i=0; i<n; i++){
+		assignment[i] = solution->assignment[i];
+	}
+	return result;
+}
+
+SolverInsertion Solver::insertPoints(const SolverParams& params, const double* coordinates, int count, int* assignment){
+	if(solution == NULL){
+		throw invalid_argument("points can only be inserted after solve");
+	}
+	if(count < 0){
+		throw invalid_argument("number of points must not be negative");
+	}
+	ChronoReal timer;
+	timer.Start();
+	if(!ownsDistances || !distances->addPoints(coordinates, count)){
+		throw invalid_argument("points can only be inserted into an instance built from coordinates by this solver");
+	}
+	OnlineInsertion insertion(params.repairMoves);
+	SolverInsertion result;
+	result.repairMoves = insertion.insert(*solution);
+	result.solutionValue = solution->solutionValue;
+	timer.Stop();
+	result.milliseconds = timer.GetTime() * 1000.0;
+
+	for(int i=0; i<solution->nDataPoints; i++){
+		assignment[i] = solution->assignment[i];
+	}
+	return result;
+}
+
+SolverResult Solver::resolve(const SolverParams& params, const vector<DatasetEdit>& edits, int* assignment){
+	if(solution == NULL){
+		throw invalid_argument("an instance can only be edited after solve");
+	}
+	if(params.maxTime < 0){
+		throw invalid_argument("time limit must not be negative");
+	}
+	int remaining = solution->nDataPoints;
+	for(size_t e=0; e<edits.size(); e++){
+		if(edits[e].type == EDIT_ADD) remaining++;
+		if(edits[e].type == EDIT_REMOVE) remaining--;
+	}
+	if(remaining < solution->nClusters){
+		throw invalid_argument("edits would leave fewer points than clusters");
+	}
+	if(!DatasetEditor::validEdits(solution->nDataPoints, edits)){
+		throw invalid_argument("edit with a point index out of range");
+	}
+	// Nothing has been changed when either check fails
+	DatasetEditor editor(distances, params.repairMoves);
+	if(!ownsDistances || !editor.apply(*solution, edits)){
+		throw invalid_argument("edits can only be applied to an instance built from coordinates by this solver, in a storage other than mapped");
+	}
+
+	SolverParams warmParams = params;
+	warmParams.warmStart = true;
+	warmParams.multilevel = false;
+	return search(warmParams, assignment);
+}
@@ -0,0 +1,163 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef SOLVER_H_
+#define SOLVER_H_
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "DistanceMatrix.h"
+#include "Pair.h"
+#include "Vns.h"
+#include "Solution.h"
+#include "Random.h"
+#include "Memory.h"
+#include "VectorKernels.h"
+#include "DatasetEditor.h"
+
+using namespace std;
+
+// Parameters of one solver run. kStep and kMax fall back to the values used
+// by the command line tool (kMax = n/2, kStep = kMax/20) when left at zero.
+// The time limit is measured in process CPU time unless wallClock or
+// threadClock is set, or the local search runs on several threads (see
+// wallTime).
+struct SolverParams {
+	int nClusters;
+	double maxTime;
+	int seed;
+	int kMin;
+	int kStep;
+	int kMax;
+	bool verbose;
+	bool wallClock;
+	bool threadClock;     // CPU time of the calling thread, for concurrent runs
+	bool multilevel;      // coarsen-solve-refine, see Multilevel.h
+	int coarsestSize;     // coarsening stops below max(coarsestSize, 20k) points
+	ConstructionMethod construction;
+	int polishPeriod;     // balanced reassignment every polishPeriod iterations, 0 = off
+	bool polishAfterShaking;
+	int cyclicLength;     // longest cyclic exchange in the local search, 0 = swaps only
+	bool pairDescent;     // swap descent that rescans only the cluster pairs a swap changed
+	int searchThreads;    // threads of the local search over disjoint cluster pairs, 1 = serial
+	ShakePolicy shakePolicy;
+	int eliteSize;        // local optima kept for path relinking, 0 = off
+	int relinkPeriod;     // iterations between path relinking walks
+	int visitedSize;      // hashes of visited local optima kept, 0 = off
+	RandomEngine rngEngine;
+	int threads;          // threads for building the distance matrix, 0 = all cores
+	HugePagePolicy hugePages; // process-wide, as cpuLevel: applied by the command line tool only
+	bool cpuAuto;             // use the widest vector kernels of the host, see VectorKernels.h;
+	CpuLevel cpuLevel;        // process-wide, so applied by the command line tool only
+	bool prefault;
+	bool storageAuto;         // let the Planner choose the distance storage
+	DistanceStorage storage;
+	int memoryCap;            // MB available to the planner, 0 = 80% of the physical memory
+	string spillDirectory;    // file of the mapped storage, empty = $TMPDIR or /tmp
+	int cacheSize;            // MB of rows cached by the mapped storage, 0 = what the memory cap leaves
+	double validatePeriod;    // seconds between background checks of the incumbent, 0 = off
+	int repairMoves;          // repair swaps per point added by insertPoints
+	bool warmStart;           // run starts from the solution it is given, see Vns::setWarmStart
+	int sweepTo;              // command line: solve every k from nClusters to sweepTo, see KSweep.h; 0 = off
+
+	SolverParams();
+	// Sets one parameter by name; returns false for unknown names or bad values.
+	bool set(const string& name, const string& value);
+	// Parses a whitespace separated list of name=value pairs.
+	bool parse(const string& options);
+	// Applies the options that tune the search itself to a Vns object.
+	void configure(Vns& vns) const;
+	// Whether the time limit is wall-clock time: wallClock, or a local search
+	// on more than one thread, whose helpers would drain a process CPU
+	// budget and whose barrier waits a thread clock would not count.
+	bool wallTime() const;
+};
+
+struct SolverProgress {
+	int iteration;
+	double solutionValue;
+	double time;
+	int k;
+};
+
+struct SolverResult {
+	double solutionValue;
+	double time;
+	int nIterations;
+	bool cancelled;
+};
+
+struct SolverInsertion {
+	double solutionValue;
+	double milliseconds;      // wall time of the batch, distances included
+	int repairMoves;
+};
+
+// Embeddable front end of the LIMA-VNS. The input is either a contiguous
+// coordinate buffer, a precomputed distance matrix or an already built
+// DistanceMatrix shared between several solvers. Coordinates are copied and
+// the distances built by solve, in the storage params.storage names or the
+// Planner picks within params.memoryCap; the other two inputs keep their
+// matrix, and solve rejects storage= and memory= for them.
+class Solver {
+public:
+	Solver(const double* coordinates, int nPoints, int nDimensions);
+	Solver(const double* distanceMatrix, int nPoints);
+	Solver(DistanceMatrix* _distances, vector< vector<Pair> >* _rankedEntities);
+	~Solver();
+
+	void setProgressCallback(function<void(const SolverProgress&)> callback);
+	void setCancelCallback(function<bool()> callback);
+
+	// Runs the VNS and writes the cluster of every point into assignment,
+	// which must hold getNumberOfPoints() entries.
+	SolverResult solve(const SolverParams& params, int* assignment);
+	// Appends count points, given as row-major coordinates, to the instance
+	// and assigns them in the solution of the last solve without a new
+	// search (see OnlineInsertion.h). Only for instances built from
+	// coordinates by this solver. assignment receives the cluster of every
+	// point, old and new, and must hold getNumberOfPoints() entries after
+	// the call.
+	SolverInsertion insertPoints(const SolverParams& params, const double* coordinates, int count, int* assignment);
+	// Applies edits to the instance and to the solution of the last solve
+	// (see DatasetEditor.h), then continues the VNS from that solution for
+	// params.maxTime; the multilevel mode is not used. Same restrictions
+	// and assignment buffer as insertPoints. Invalid edits throw
+	// invalid_argument before anything is changed.
+	SolverResult resolve(const SolverParams& params, const vector<DatasetEdit>& edits, int* assignment);
+	int getNumberOfPoints();
+
+	// Runs the search selected by params on solution; shared with the
+	// command line tool. Returns the number of VNS iterations.
+	static int run(const SolverParams& params, Solution& solution, DistanceMatrix* distances,
+			vector< vector<Pair> >* rankedEntities, Random* random,
+			function<void(int, double, double, int)> progress = NULL, function<bool()> cancel = NULL);
+
+private:
+	DistanceMatrix* distances;
+	bool ownsDistances;
+	vector<double> coordinates;   // until the first solve builds distances
+	int nPoints;
+	int nDimensions;
+	vector< vector<Pair> > ownedRankedEntities;
+	vector< vector<Pair> >* rankedEntities;
+	Solution* solution;     // from the last solve, kept for insertPoints
+
+	function<void(const SolverProgress&)> progressCallback;
+	function<bool()> cancelCallback;
+
+	SolverResult search(const SolverParams& params, int* assignment);
+	// Builds the distances from the coordinates, or rebuilds them when the
+	// storage chosen for params differs from theirs.
+	void prepareDistances(const SolverParams& params);
+	Solver(const Solver&);
+	Solver& operator=(const Solver&);
+};
+#endif /* SOLVER_H_ */
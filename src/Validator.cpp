@@ -0,0 +1,190 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "Validator.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+
+using namespace std;
+
+// Relative tolerance on the objective and on every sc entry.
+static const double DRIFT_TOLERANCE = 1e-9;
+
+Validator::Validator(double _period, ostream& _out) : out(_out) {
+	period = _period;
+	wanted = false;
+	delivered = false;
+	stopping = false;
+	snapshot = NULL;
+	snapshotIteration = 0;
+	checks = 0;
+	problems = 0;
+	worker = thread(&Validator::run, this);
+}
+
+Validator::~Validator(){
+	stop();
+	delete snapshot;
+}
+
+void Validator::submit(const Solution& solution, int iteration){
+	if(!wanted) return;
+
+	lock_guard<mutex> guard(lock);
+	if(snapshot == NULL){
+		snapshot = new Solution(solution);
+	}else{
+		snapshot->copy(solution);
+	}
+	snapshotIteration = iteration;
+	wanted = false;
+	delivered = true;
+	changed.notify_all();
+}
+
+void Validator::stop(){
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+		wanted = false;
+		changed.notify_all();
+	}
+	if(worker.joinable()) worker.join();
+}
+
+int Validator::getChecks(){
+	lock_guard<mutex> guard(lock);
+	return checks;
+}
+
+int Validator::getProblems(){
+	lock_guard<mutex> guard(lock);
+	return problems;
+}
+
+void Validator::run(){
+	unique_lock<mutex> guard(lock);
+	while(!stopping){
+		changed.wait_for(guard, chrono::duration<double>(period), [this]{ return stopping; });
+		if(stopping) break;
+
+		wanted = true;
+		changed.wait(guard, [this]{ return delivered || stopping; });
+		if(!delivered) break;
+		delivered = false;
+
+		// The search never writes the snapshot while no new one is wanted
+		guard.unlock();
+		int found = check(*snapshot, snapshotIteration);
+		guard.lock();
+		checks++;
+		problems += found;
+	}
+}
+
+// Recomputes everything derived from the assignment with plain loops over
+// the distances, independently of the optimized kernels.
+int Validator::check(Solution& solution, int iteration){
+	int n = solution.nDataPoints;
+	int k = solution.nClusters;
+	int found = 0;
+
+	vector<int> sizes(k, 0);
+	for(int i=0; i<n; i++){
+		int c = solution.assignment[i];
+		if(c < 0 || c >= k){
+			out << "Validator: iteration " << iteration << ": point " << i << " has cluster " << c << endl;
+			return 1;
+		}
+		sizes[c]++;
+	}
+
+	// Sizes must match clusterSizes, the member lists and, as a multiset, the balanced sizes
+	vector<int> targets(k), actual(sizes);
+	for(int c=0; c<k; c++){
+		targets[c] = solution.targetSize(c);
+		if(sizes[c] != solution.clusterSizes[c] || sizes[c] != (int)solution.members[c].size()){
+			out << "Validator: iteration " << iteration << ": cluster " << c << " has " << sizes[c]
+					<< " points, clusterSizes says " << solution.clusterSizes[c]
+					<< ", members " << solution.members[c].size() << endl;
+			found++;
+		}
+	}
+	sort(targets.begin(), targets.end());
+	sort(actual.begin(), actual.end());
+	if(targets != actual){
+		out << "Validator: iteration " << iteration << ": cluster sizes violate the balance constraint" << endl;
+		found++;
+	}
+	for(int c=0; c<k; c++){
+		for(size_t p=0; p<solution.members[c].size(); p++){
+			int i = solution.members[c][p];
+			if(solution.assignment[i] != c || solution.position[i] != (int)p){
+				out << "Validator: iteration " << iteration << ": member list of cluster " << c << " is inconsistent" << endl;
+				found++;
+				break;
+			}
+		}
+	}
+
+	uint64_t hash = 0;
+	vector<uint64_t> clusterHash(k, 0);
+	for(int i=0; i<n; i++){
+		clusterHash[solution.assignment[i]] ^= Solution::pointKey(i);
+	}
+	for(int c=0; c<k; c++){
+		hash += Solution::mixHash(clusterHash[c]);
+	}
+	if(hash != solution.hash){
+		out << "Validator: iteration " << iteration << ": partition hash is out of date" << endl;
+		found++;
+	}
+
+	// sc and the objective
+	vector<double> row(k);
+	vector<double> pairSum(k, 0.0);
+	double worstDrift = 0.0;
+	int worstPoint = -1;
+	for(int i=0; i<n; i++){
+		fill(row.begin(), row.end(), 0.0);
+		double scale = 0.0;
+		for(int j=0; j<n; j++){
+			double d = solution.distances->getDistance(i, j);
+			row[solution.assignment[j]] += d;
+			scale += d;
+		}
+		for(int c=0; c<k; c++){
+			double drift = fabs(row[c] - solution.sc[i][c]) / max(scale, 1e-300);
+			if(drift > worstDrift){
+				worstDrift = drift;
+				worstPoint = i;
+			}
+		}
+		pairSum[solution.assignment[i]] += row[solution.assignment[i]] / 2.0;
+	}
+	if(worstDrift > DRIFT_TOLERANCE){
+		out << "Validator: iteration " << iteration << ": sc drifted by " << worstDrift
+				<< " (relative) at point " << worstPoint << endl;
+		found++;
+	}
+
+	double value = 0.0;
+	for(int c=0; c<k; c++){
+		if(sizes[c] > 0) value += pairSum[c] / sizes[c];
+	}
+	double drift = fabs(value - solution.solutionValue) / max(fabs(value), 1e-300);
+	if(drift > DRIFT_TOLERANCE){
+		out << "Validator: iteration " << iteration << ": objective is " << solution.solutionValue
+				<< ", recomputed " << value << " (relative drift " << drift << ")" << endl;
+		found++;
+	}
+	return found;
+}
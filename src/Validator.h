@@ -0,0 +1,59 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef VALIDATOR_H_
+#define VALIDATOR_H_
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <iostream>
+#include "Solution.h"
+
+using namespace std;
+
+// Background check of the incremental state of the incumbent. Every period
+// seconds the worker thread asks for a snapshot, which the search hands over
+// at its next submit; the worker then recomputes sc, the objective, the
+// cluster sizes and the partition hash from the distances alone and reports
+// every mismatch to out.
+// submit returns at once when no snapshot is wanted, so the search is only
+// delayed by one O(nk) copy per period.
+class Validator {
+public:
+	Validator(double _period, ostream& _out);
+	~Validator();
+
+	void submit(const Solution& solution, int iteration);
+	// Waits for the check in progress, if any, and stops the thread.
+	void stop();
+
+	int getChecks();
+	int getProblems();
+
+private:
+	double period;
+	ostream& out;
+	thread worker;
+	mutex lock;
+	condition_variable changed;
+	atomic<bool> wanted;
+	bool delivered;
+	bool stopping;
+
+	Solution* snapshot;
+	int snapshotIteration;
+	int checks;
+	int problems;
+
+	void run();
+	int check(Solution& solution, int iteration);
+};
+#endif /* VALIDATOR_H_ */
@@ -0,0 +1,128 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "VectorKernels.h"
+#include <atomic>
+
+using namespace std;
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VECTOR_LEVELS 1
+#endif
+
+// Bodies shared by every level, inlined into the per-level wrappers below.
+static inline __attribute__((always_inline)) void tileProductsBody(double* dot, const double* transposed,
+		const double* coordinates, int nDimensions, int rowBegin, int rowEnd, int dBegin, int dEnd, int width, int tile){
+	for(int i=rowBegin; i<rowEnd; i++){
+		const double* x = coordinates + (size_t)i*nDimensions;
+		double* dotRow = dot + (size_t)(i - rowBegin)*tile;
+		for(int d=dBegin; d<dEnd; d++){
+			double xd = x[d];
+			const double* column = transposed + (size_t)(d - dBegin)*tile;
+			for(int j=0; j<width; j++){
+				dotRow[j] += xd*column[j];
+			}
+		}
+	}
+}
+
+static inline __attribute__((always_inline)) void squaredDistancesBody(double* row, const double* transposed,
+		const double* x, int nDimensions, int count){
+	for(int j=0; j<count; j++) row[j] = 0.0;
+	for(int d=0; d<nDimensions; d++){
+		double xd = x[d];
+		const double* column = transposed + (size_t)d*count;
+		for(int j=0; j<count; j++){
+			row[j] += (xd - column[j])*(xd - column[j]);
+		}
+	}
+}
+
+static inline __attribute__((always_inline)) void swapDeltasBody(double* deltas, const double* columnA,
+		const double* columnB, const double* distance, int count, double base, double invA, double invB, double invSum){
+	for(int m=0; m<count; m++){
+		deltas[m] = base + columnA[m] * invA - columnB[m] * invB - distance[m] * invSum;
+	}
+}
+
+// One set of wrappers per level; the compiler vectorizes each inlined body
+// for the instructions its target attribute allows.
+#define DEFINE_LEVEL(suffix, target) \
+	target static void tileProducts##suffix(double* dot, const double* transposed, const double* coordinates, \
+			int nDimensions, int rowBegin, int rowEnd, int dBegin, int dEnd, int width, int tile){ \
+		tileProductsBody(dot, transposed, coordinates, nDimensions, rowBegin, rowEnd, dBegin, dEnd, width, tile); \
+	} \
+	target static void squaredDistances##suffix(double* row, const double* transposed, const double* x, \
+			int nDimensions, int count){ \
+		squaredDistancesBody(row, transposed, x, nDimensions, count); \
+	} \
+	target static void swapDeltas##suffix(double* deltas, const double* columnA, const double* columnB, \
+			const double* distance, int count, double base, double invA, double invB, double invSum){ \
+		swapDeltasBody(deltas, columnA, columnB, distance, count, base, invA, invB, invSum); \
+	} \
+	static const VectorKernels KERNELS_##suffix = { tileProducts##suffix, squaredDistances##suffix, swapDeltas##suffix };
+
+DEFINE_LEVEL(SSE2, )
+#ifdef VECTOR_LEVELS
+DEFINE_LEVEL(AVX2, __attribute__((target("avx2"))))
+DEFINE_LEVEL(AVX512, __attribute__((target("avx512f"))))
+#endif
+
+bool parseCpuLevel(const string& name, CpuLevel& level){
+	if(name == "sse2") level = CPU_SSE2;
+	else if(name == "avx2") level = CPU_AVX2;
+	else if(name == "avx512") level = CPU_AVX512;
+	else return false;
+	return true;
+}
+
+const char* cpuLevelName(CpuLevel level){
+	switch(level){
+	case CPU_SSE2: return "sse2";
+	case CPU_AVX2: return "avx2";
+	case CPU_AVX512: return "avx512";
+	}
+	return "unknown";
+}
+
+// __builtin_cpu_supports also checks that the operating system saves the
+// vector registers.
+CpuLevel detectCpuLevel(){
+#ifdef VECTOR_LEVELS
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f")) return CPU_AVX512;
+	if(__builtin_cpu_supports("avx2")) return CPU_AVX2;
+#endif
+	return CPU_SSE2;
+}
+
+static const VectorKernels& kernelsFor(CpuLevel level){
+#ifdef VECTOR_LEVELS
+	if(level == CPU_AVX512) return KERNELS_AVX512;
+	if(level == CPU_AVX2) return KERNELS_AVX2;
+#endif
+	return KERNELS_SSE2;
+}
+
+// Atomic, as the daemon solves on several threads; a change only takes
+// effect for the kernels fetched after it.
+static atomic<int> selectedLevel(detectCpuLevel());
+
+void setCpuLevel(CpuLevel level){
+	CpuLevel supported = detectCpuLevel();
+	selectedLevel = level < supported ? level : supported;
+}
+
+CpuLevel getCpuLevel(){
+	return (CpuLevel)selectedLevel.load(memory_order_relaxed);
+}
+
+const VectorKernels& vectorKernels(){
+	return kernelsFor(getCpuLevel());
+}
@@ -0,0 +1,61 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef VECTORKERNELS_H_
+#define VECTORKERNELS_H_
+
+#include <string>
+
+using namespace std;
+
+// Instruction set levels of the vectorized kernels. The binary is built for
+// the x86-64 baseline (SSE2); the other levels are compiled alongside with
+// target attributes and chosen at run time, so one build uses the widest
+// vectors of every host. All levels give bit-identical results, since
+// floating-point contraction is disabled (see the makefile) and none of the
+// loops reassociates a sum.
+enum CpuLevel {
+	CPU_SSE2,
+	CPU_AVX2,
+	CPU_AVX512
+};
+
+// Converts "sse2", "avx2" or "avx512"; returns false for other names.
+bool parseCpuLevel(const string& name, CpuLevel& level);
+const char* cpuLevelName(CpuLevel level);
+// Highest level the processor and the operating system support.
+CpuLevel detectCpuLevel();
+// Selects the kernels of a level, capped at detectCpuLevel(), for the whole
+// process. The detected level is selected at startup; call once, before any
+// search starts (the command line tool and the daemon do it from their
+// arguments).
+void setCpuLevel(CpuLevel level);
+CpuLevel getCpuLevel();
+
+// The loops that are bound by arithmetic rather than by memory. The sc
+// update of a swap and initializeSc are not here: both are indexed
+// read-modify-writes that no level vectorizes.
+struct VectorKernels {
+	// dot[i-rowBegin][j] += x_i[d] * transposed[d-dBegin][j] for the rows
+	// rowBegin <= i < rowEnd of coordinates, dBegin <= d < dEnd and j < width,
+	// on TILE-wide rows of dot and transposed (a tile of DistanceMatrix::build).
+	void (*tileProducts)(double* dot, const double* transposed, const double* coordinates, int nDimensions,
+			int rowBegin, int rowEnd, int dBegin, int dEnd, int width, int tile);
+	// row[j] = sum over d of (x[d] - transposed[d][j])^2 for j < count, with
+	// transposed holding count values per dimension (a mapped row).
+	void (*squaredDistances)(double* row, const double* transposed, const double* x, int nDimensions, int count);
+	// deltas[m] = base + columnA[m]*invA - columnB[m]*invB - distance[m]*invSum (see DeltaKernel).
+	void (*swapDeltas)(double* deltas, const double* columnA, const double* columnB, const double* distance,
+			int count, double base, double invA, double invB, double invSum);
+};
+
+// Kernels of the selected level.
+const VectorKernels& vectorKernels();
+
+#endif /* VECTORKERNELS_H_ */
@@ -0,0 +1,30 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#include "VisitedSet.h"
+
+using namespace std;
+
+VisitedSet::VisitedSet(int capacity){
+	size_t size = 1;
+	while(size < (size_t)capacity) size <<= 1;
+	slots.assign(size, 0);
+	mask = size - 1;
+}
+
+bool VisitedSet::contains(uint64_t hash){
+	return slots[hash & mask] == hash;
+}
+
+bool VisitedSet::insert(uint64_t hash){
+	uint64_t& slot = slots[hash & mask];
+	if(slot == hash) return true;
+	slot = hash;
+	return false;
+}
@@ -0,0 +1,37 @@
+//============================================================================
+// Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+// Description : Implementation of the LIMA-VNS published in the paper "Less is 
+//               more: basic variable neighborhood search heuristic for 
+//               balanced minimum sum-of-squares clustering". Please, check
+//               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+//               details. 
+//============================================================================
+
+#ifndef VISITEDSET_H_
+#define VISITEDSET_H_
+
+#include <vector>
+#include <stdint.h>
+
+using namespace std;
+
+// Bounded set of the hashes of the local optima reached so far (see
+// Solution::hash). The table is direct-mapped with a power of two number of
+// slots: each hash has one slot and evicts whatever was stored there, so the
+// memory stays fixed and a lookup costs one probe. Hashes are 64 bits, so a
+// false match is unlikely even with millions of optima; forgotten optima are
+// simply searched again.
+class VisitedSet {
+public:
+	// Rounds capacity up to a power of two.
+	VisitedSet(int capacity);
+
+	bool contains(uint64_t hash);
+	// Records hash and returns true if it was already there.
+	bool insert(uint64_t hash);
+
+private:
+	vector<uint64_t> slots;
+	uint64_t mask;
+};
+#endif /* VISITEDSET_H_ */
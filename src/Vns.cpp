@@ -9,6 +9,8 @@
 #include "Vns.h"
 #include "Solution.h"
 #include "LocalSearch.h"
+#include "BalancedAssignment.h"
+#include "OnlineInsertion.h"
 #include <iostream>
 #include <vector>
 #include <list>
@@ -20,6 +22,7 @@
 #include <stdlib.h>
 #include <iomanip>
 #include <fstream>
+#include <sstream>
 #include <cmath>
 #include "Pair.h"
 #include <limits>
@@ -32,14 +35,15 @@ void Vns::swap(Solution& solution, int pointI, int pointJ, double delta) {
     int clusterI = solution.assignment[pointI];
     int clusterJ = solution.assignment[pointJ];
     solution.solutionValue += delta;
+    solution.distances->useRow(pointI);
+    solution.distances->useRow(pointJ);
     for (int k = 0; k < solution.nDataPoints; k++) {
-        double dist_k_I = solution.distances->getDistance(k, pointI);
-        double dist_k_J = solution.distances->getDistance(k, pointJ);
+        double dist_k_I = solution.distances->getDistance(pointI, k);
+        double dist_k_J = solution.distances->getDistance(pointJ, k);
         solution.sc[k][clusterI] = solution.sc[k][clusterI] - dist_k_I + dist_k_J;
         solution.sc[k][clusterJ] = solution.sc[k][clusterJ] + dist_k_I - dist_k_J;
     }
-    solution.assignment[pointI] = clusterJ;
-    solution.assignment[pointJ] = clusterI;
+    solution.swapPoints(pointI, pointJ);
 }
 
 // Constructor to initialize the VNS algorithm parameters
@@ -50,56 +54,185 @@ Vns::Vns(vector<Point>* _dataset, DistanceMatrix *_distances, int _nClusters, Ra
     random = _random;
     rankedEntities = _rankedEntities;
     k = 1; // Initialize neighborhood size
-    timer = ChronoCPU();
+    verbose = true;
+    warmStart = false;
+    construction = CONSTRUCTION_RANDOM;
+    polishPeriod = 0;
+    polishAfterShaking = false;
+    cyclicLength = 0;
+    pairDescent = false;
+    searchThreads = 1;
+    shakePolicy = SHAKE_CYCLIC;
+    validator = NULL;
+    eliteSize = 0;
+    relinkPeriod = 0;
+    visitedSize = 0;
+    timer = &cpuTimer;
+}
+
+void Vns::setProgressCallback(function<void(int, double, double, int)> callback) {
+    progressCallback = callback;
+}
+
+void Vns::setCancelCallback(function<bool()> callback) {
+    cancelCallback = callback;
+}
+
+void Vns::setVerbose(bool _verbose) {
+    verbose = _verbose;
+}
+
+void Vns::setTimer(Chrono* _timer) {
+    timer = _timer != NULL ? _timer : &cpuTimer;
+}
+
+void Vns::setWarmStart(bool _warmStart) {
+    warmStart = _warmStart;
+}
+
+void Vns::setConstruction(ConstructionMethod method) {
+    construction = method;
+}
+
+void Vns::setPolishing(int period, bool afterShaking) {
+    polishPeriod = period;
+    polishAfterShaking = afterShaking;
+}
+
+void Vns::setCyclicExchange(int maxLength) {
+    cyclicLength = maxLength;
+}
+
+void Vns::setPairDescent(bool enabled) {
+    pairDescent = enabled;
+}
+
+void Vns::setSearchThreads(int nThreads) {
+    searchThreads = nThreads;
+}
+
+void Vns::setShakePolicy(ShakePolicy policy) {
+    shakePolicy = policy;
+}
+
+void Vns::setValidator(Validator* _validator) {
+    validator = _validator;
+}
+
+void Vns::setElitePool(int size, int _relinkPeriod) {
+    eliteSize = size;
+    relinkPeriod = _relinkPeriod;
+}
+
+void Vns::setVisitedSet(int size) {
+    visitedSize = size;
 }
 
 // Main execution method for the VNS algorithm
 int Vns::execute(Solution& bestSolution, double tempMax, int kMin, int kStep, int kMax, string outputFileName) {
-    timer.Start();
+    timer->Start();
     int iter = 0;
 
     LocalSearch localSearch(dataset, random, rankedEntities);
+    localSearch.setCancelCallback(cancelCallback);
+    localSearch.setCyclicExchange(cyclicLength);
+    localSearch.setPairDescent(pairDescent);
+    localSearch.setThreads(searchThreads);
+    VisitedSet visited(visitedSize);
+    int optima = 0, revisits = 0;
 
-    // 1. Generate a random, balanced initial solution
-    initialSolution(bestSolution);
+    // 1. Generate a random, balanced initial solution unless one was given
+    if (!warmStart) initialSolution(bestSolution);
     // 2. Improve it with local search to find the first local optimum
-    localSearch.execute(bestSolution, &timer, tempMax, iter);
+    localSearch.execute(bestSolution, timer, tempMax, iter);
+    BalancedAssignment polisher;
+    if (polishPeriod > 0 && polisher.polish(bestSolution)) {
+        localSearch.execute(bestSolution, timer, tempMax, iter);
+    }
+    bestSolution.time = timer->GetTime();
+    if (visitedSize > 0) {
+        visited.insert(bestSolution.hash);
+        localSearch.setVisited(&visited);
+    }
 
-    cout << "Initial Solution Value: " << fixed << setprecision(5) << bestSolution.solutionValue << endl;
+    if (verbose) cout << "Initial Solution Value: " << fixed << setprecision(5) << bestSolution.solutionValue << " at " << setprecision(4) << bestSolution.time << "s" << endl;
+    if (progressCallback) progressCallback(iter, bestSolution.solutionValue, bestSolution.time, 0);
     
-    k = kMin; // Start with the smallest neighborhood size
+    // The controller starts with the smallest neighborhood size
+    ShakeController controller(shakePolicy, kMin, kStep, kMax, random);
+
+    // Working solution, allocated once and overwritten every iteration
+    Solution currentSolution(bestSolution);
+
+    // Diverse local optima met so far, used as guides for path relinking
+    ElitePool elitePool(eliteSize, bestSolution.nDataPoints, bestSolution.nClusters);
+    elitePool.insert(bestSolution);
+    int relinks = 0, relinkImprovements = 0;
 
     // Main VNS loop - CORRECTED to only check time limit
-    while (timer.GetTime() < tempMax) {
+    while (timer->GetTime() < tempMax) {
+        if (cancelCallback && cancelCallback()) break;
+        if (validator) validator->submit(bestSolution, iter);
         iter++;
+        k = controller.next();
+        double iterationStart = timer->GetTime();
 
-        // 1. Create a working copy of the current best solution
-        Solution currentSolution(bestSolution);
+        // 1. Reset the working solution to the current best solution
+        currentSolution.copy(bestSolution);
 
         // 2. Shaking: Perturb the solution by applying 'k' random swaps
         shaking(currentSolution);
+        if (polishAfterShaking) polisher.polish(currentSolution);
         
         // 3. Local Search: Find the local optimum from the shaken solution
-        localSearch.execute(currentSolution, &timer, tempMax, iter);
+        localSearch.execute(currentSolution, timer, tempMax, iter);
+        if (polishPeriod > 0 && iter % polishPeriod == 0 && polisher.polish(currentSolution)) {
+            localSearch.execute(currentSolution, timer, tempMax, iter);
+        }
+
+        if (visitedSize > 0) {
+            optima++;
+            if (visited.insert(currentSolution.hash)) revisits++;
+        }
+
+        // 3b. Path relinking: walk towards a random elite and search again from the best point on the way
+        if (eliteSize > 0) {
+            elitePool.insert(currentSolution);
+            if (relinkPeriod > 0 && iter % relinkPeriod == 0 && elitePool.size() > 1) {
+                double reference = min(currentSolution.solutionValue, bestSolution.solutionValue);
+                int guide = random->get_rand(elitePool.size()) - 1;
+                if (elitePool.relink(currentSolution, guide, localSearch, random) > 0) {
+                    localSearch.execute(currentSolution, timer, tempMax, iter);
+                    elitePool.insert(currentSolution);
+                    if (visitedSize > 0) visited.insert(currentSolution.hash);
+                    relinks++;
+                    if (currentSolution.solutionValue < reference - 1e-9) relinkImprovements++;
+                }
+            }
+        }
 
         // 4. Move or Stay: Compare the new local optimum with the best-so-far solution
+        double gain = 0.0;
         if (currentSolution.solutionValue < bestSolution.solutionValue - 1e-9) {
+            gain = bestSolution.solutionValue - currentSolution.solutionValue;
             bestSolution.copy(currentSolution);
-            cout << "Iteration " << iter << ": Found new best solution = " << fixed << setprecision(5) << bestSolution.solutionValue << " (k=" << k << ")" << endl;
-            k = kMin; // Improvement found, reset to the smallest neighborhood
-        } else {
-            k += kStep; // No improvement, increase the neighborhood size
-            // CORRECTED: If k exceeds kMax, reset it to kMin to continue searching
-            if (k > kMax) {
-                k = kMin;
-            }
+            bestSolution.time = timer->GetTime();
+            if (progressCallback) progressCallback(iter, bestSolution.solutionValue, bestSolution.time, k);
+            if (verbose) cout << "Iteration " << iter << ": Found new best solution = " << fixed << setprecision(5) << bestSolution.solutionValue << " (k=" << k << ") at " << setprecision(4) << bestSolution.time << "s" << endl;
         }
+        // With the cyclic policy an improvement resets k to kMin, otherwise k grows by kStep and wraps after kMax
+        controller.report(gain, bestSolution.solutionValue + gain, timer->GetTime() - iterationStart);
     }
     
-    timer.Stop();
-    cout << "VNS finished. Total iterations: " << iter << endl;
-    cout << "Final best solution value: " << fixed << setprecision(5) << bestSolution.solutionValue << endl;
-    cout << "Total time: " << timer.GetTime() << "s" << endl;
+    timer->Stop();
+    if (verbose) {
+        cout << "VNS finished. Total iterations: " << iter << endl;
+        cout << "Final best solution value: " << fixed << setprecision(5) << bestSolution.solutionValue << endl;
+        cout << "Total time: " << timer->GetTime() << "s" << endl;
+        if (shakePolicy != SHAKE_CYCLIC) controller.print(cout);
+        if (visitedSize > 0) cout << "Local optima: " << optima << " reached, " << revisits << " revisits (" << fixed << setprecision(1) << (optima > 0 ? 100.0 * revisits / optima : 0.0) << "%), " << localSearch.getCutoffs() << " searches cut short" << endl;
+        if (eliteSize > 0) cout << "Path relinking: " << relinks << " walks, " << relinkImprovements << " new best solutions, " << elitePool.size() << " elites" << endl;
+    }
     
     return iter;
 }
@@ -107,18 +240,23 @@ int Vns::execute(Solution& bestSolution, double tempMax, int kMin, int kStep, in
 
 // Shaking function: Applies 'k' random swaps to the solution
 bool Vns::shaking(Solution& solution) {
+    if (solution.nClusters < 2) return false;
+
     // OPTIMIZED: Calls the internal swap method directly
     for (int i = 0; i < k; ++i) {
-        int pointA, pointB;
-        
-        // Find two points in different clusters to ensure a valid swap
-        do {
-            pointA = random->get_rand(solution.nDataPoints);
-            pointB = random->get_rand(solution.nDataPoints);
-        } while (pointA == pointB || solution.assignment[pointA] == solution.assignment[pointB]);
-
+        // Draw pointA, then pointB directly among the points of the other
+        // clusters through the member lists (get_rand draws from [1, size])
+        int pointA = random->get_rand(solution.nDataPoints) - 1;
         int clusterA = solution.assignment[pointA];
-        int clusterB = solution.assignment[pointB];
+        int r = random->get_rand(solution.nDataPoints - solution.members[clusterA].size()) - 1;
+        int clusterB = 0;
+        for (;; clusterB++) {
+            if (clusterB == clusterA) continue;
+            int size = solution.members[clusterB].size();
+            if (r < size) break;
+            r -= size;
+        }
+        int pointB = solution.members[clusterB][r];
         double dist_ab = solution.distances->getDistance(pointA, pointB);
 
         // Calculate the delta for this random swap
@@ -131,8 +269,17 @@ bool Vns::shaking(Solution& solution) {
     return true;
 }
 
-// Generates a random, balanced initial solution
+// Generates a balanced initial solution, random unless a constructive heuristic was selected
 void Vns::initialSolution(Solution& initial) {
+    if (construction == CONSTRUCTION_KMEANSPP) {
+        Construction(random).kMeansPlusPlus(initial);
+        return;
+    }
+    if (construction == CONSTRUCTION_REGRET) {
+        Construction(random).regret(initial);
+        return;
+    }
+
     int n = initial.nDataPoints;
     int k = initial.nClusters;
 
@@ -159,20 +306,8 @@ void Vns::initialSolution(Solution& initial) {
     // Initialize the sc matrix based on the new assignments
     initial.initializeSc();
 
-    // Calculate the initial solution value from scratch
-    initial.solutionValue = 0;
-    for (int c = 0; c < k; c++) {
-        double intraClusterSum = 0;
-        for (int i = 0; i < n; i++) {
-            if (initial.assignment[i] == c) {
-                // Using the sc matrix for efficient calculation
-                // sc[i][c] is sum of distances from i to all points in cluster c
-                intraClusterSum += initial.sc[i][c];
-            }
-        }
-        // Each pair distance is counted twice in the sum, so divide by 2
-        initial.solutionValue += (intraClusterSum / 2.0) / initial.clusterSizes[c];
-    }
+    // Calculate the initial solution value from the sc matrix
+    initial.evaluate();
 }
 
 
@@ -228,9 +363,50 @@ bool Vns::checkSolution(Solution* solution) {
     return true; // Solution is valid
 }
 
-void Vns::loadInitialSolution(Solution& solution, const std::string& filename) {
-    // This function is a stub and would need to be implemented if loading from a file is required.
-    // It would involve reading a file that specifies the assignment of each point to a cluster.
-    // After loading assignments, it must call initialSolution logic to set clusterSizes, sc matrix, and solutionValue.
-    cerr << "Warning: loadInitialSolution is not implemented." << endl;
-}
\ No newline at end of file
+bool Vns::loadInitialSolution(Solution& solution, const std::string& filename) {
+    vector<int> labels;
+    ifstream file(filename.c_str(), ios::binary);
+    if (!file.good()) {
+        cerr << "Cannot read the initial solution " << filename << endl;
+        return false;
+    }
+    if (filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".bin") == 0) {
+        int header[5];
+        if (file.read((char*)header, sizeof(header)) && header[3] > 0) {
+            labels.resize(header[3]);
+            file.read((char*)&labels[0], sizeof(int) * labels.size());
+            if (!file) labels.clear();
+        }
+    } else {
+        string line, field;
+        getline(file, line);
+        stringstream fields(line);
+        getline(fields, field, ',');   // the instance
+        while (getline(fields, field, ',')) labels.push_back(atoi(field.c_str()));
+    }
+
+    int n = solution.nDataPoints;
+    int count = min((int)labels.size(), n);
+    for (int i = 0; i < count; i++) {
+        if (labels[i] < 0 || labels[i] >= solution.nClusters) count = 0;
+    }
+    if (count == 0) {
+        cerr << "Invalid initial solution " << filename << endl;
+        return false;
+    }
+
+    // sc of the points read, then the others are inserted into it
+    for (int c = 0; c < solution.nClusters; c++) solution.clusterSizes[c] = 0;
+    for (int i = 0; i < count; i++) {
+        solution.assignment[i] = labels[i];
+        solution.clusterSizes[labels[i]]++;
+    }
+    solution.resize(count);
+    solution.initializeSc();
+    solution.resize(n);
+    vector<int> missing;
+    for (int i = count; i < n; i++) missing.push_back(i);
+    if (!missing.empty()) OnlineInsertion(2).assignPoints(solution, missing);
+    solution.rebalance();
+    return true;
+}
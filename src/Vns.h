@@ -18,7 +18,12 @@
 #include <random>
 #include "Random.h"
 #include <iomanip>
+#include <functional>
 #include "Pair.h"
+#include "Construction.h"
+#include "ShakeController.h"
+#include "Validator.h"
+#include "ElitePool.h"
 
 using namespace std;
 
@@ -26,18 +31,78 @@ class Vns {
 public:
 	Vns(vector<Point>* _dataset, DistanceMatrix* _distances, int _nClusters, Random* _random, vector< vector<Pair> >* _rankedEntities);
 	int execute(Solution& bestSolution, double tempMax, int kMin, int kStep, int kMax, string outputFileName);
-	void loadInitialSolution(Solution& solution, const std::string& filename);
+	// Reads an assignment, either a .bin initial solution (five int header
+	// ending with n and k, then n ints) or a line of an assignment file
+	// written by lima_vns ("instance, c1, c2, ..."), and makes solution
+	// consistent with it for a warm start. A file covering fewer points than
+	// the instance has the others inserted as by OnlineInsertion; entries
+	// beyond the instance are ignored. The sizes are then rebalanced with the
+	// fewest moves. Returns false if the file cannot be read.
+	bool loadInitialSolution(Solution& solution, const std::string& filename);
+
+	// Called with (iteration, solution value, elapsed time, k) whenever a new best solution is found.
+	void setProgressCallback(function<void(int, double, double, int)> callback);
+	// Polled between iterations and local search passes; returning true stops the search.
+	void setCancelCallback(function<bool()> callback);
+	void setVerbose(bool _verbose);
+	// Replaces the default CPU time clock used for the time limit, e.g. by a wall clock.
+	void setTimer(Chrono* _timer);
+	// When set, execute starts from the solution it is given (which must have a
+	// consistent sc matrix and value) instead of building a random one.
+	void setWarmStart(bool _warmStart);
+	void setConstruction(ConstructionMethod method);
+	// Applies the balanced reassignment polish (see BalancedAssignment.h) to
+	// the local optimum of every period-th iteration, and additionally right
+	// after shaking when afterShaking is set. A period of 0 disables it.
+	void setPolishing(int period, bool afterShaking);
+	// Forwarded to LocalSearch::setCyclicExchange.
+	void setCyclicExchange(int maxLength);
+	// Forwarded to LocalSearch::setPairDescent.
+	void setPairDescent(bool enabled);
+	// Forwarded to LocalSearch::setThreads.
+	void setSearchThreads(int nThreads);
+	// Selects how the shaking strength k is chosen; the statistics per k are
+	// printed at the end of execute for the adaptive policies.
+	void setShakePolicy(ShakePolicy policy);
+	// Hands the incumbent to validator whenever it asks for a snapshot.
+	void setValidator(Validator* _validator);
+	// Keeps up to size diverse local optima (see ElitePool.h) and, every
+	// relinkPeriod iterations, relinks the current local optimum with a random
+	// elite and runs the local search from the best point of the path. A size
+	// of 0 disables both.
+	void setElitePool(int size, int relinkPeriod);
+	// Records the hashes of up to about size local optima (see VisitedSet.h)
+	// so that local searches stop on a known one, and reports the revisit
+	// rate in verbose runs. 0 disables it.
+	void setVisitedSet(int size);
 
 private:
 	int nClusters;
 	int k;
+	bool verbose;
+	bool warmStart;
+	ConstructionMethod construction;
+	int polishPeriod;
+	bool polishAfterShaking;
+	int cyclicLength;
+	bool pairDescent;
+	int searchThreads;
+	ShakePolicy shakePolicy;
+	Validator* validator;
+	int eliteSize;
+	int relinkPeriod;
+	int visitedSize;
 
 	Random* random;
 	vector<Point>* dataset;
 	DistanceMatrix* distances;
 	vector< vector<Pair> >* rankedEntities;
 
-	ChronoCPU timer;
+	ChronoCPU cpuTimer;
+	Chrono* timer;
+
+	function<void(int, double, double, int)> progressCallback;
+	function<bool()> cancelCallback;
 
 	bool shaking(Solution& solution);
 	void initialSolution(Solution& initial);
@@ -0,0 +1,65 @@
+/*============================================================================
+ * Author      : Leandro R. Costa, Daniel Aloise, Nenad Mladenovic.
+ * Description : Implementation of the LIMA-VNS published in the paper "Less is 
+ *               more: basic variable neighborhood search heuristic for 
+ *               balanced minimum sum-of-squares clustering". Please, check
+ *               https://doi.org/10.1016/j.ins.2017.06.019 for theoretical 
+ *               details. 
+ *
+ *               C interface of the solver library (liblima_vns).
+ *============================================================================*/
+
+#ifndef LIMA_VNS_C_H_
+#define LIMA_VNS_C_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+	LIMA_OK = 0,
+	LIMA_CANCELLED = 1,          /* stopped by the cancel callback, result holds the best solution so far */
+	LIMA_INVALID_ARGUMENT = -1,
+	LIMA_OUT_OF_MEMORY = -2,
+	LIMA_INTERNAL_ERROR = -3
+};
+
+typedef struct lima_params {
+	int n_clusters;
+	double max_time;             /* cpu time limit in seconds */
+	int seed;
+	int k_min;
+	int k_step;                  /* 0 selects k_max/20 */
+	int k_max;                   /* 0 selects n_points/2 */
+	const char* options;         /* optional "name=value ..." list, may be NULL */
+} lima_params;
+
+typedef struct lima_result {
+	double solution_value;
+	double time;                 /* time at which the best solution was found */
+	int n_iterations;
+} lima_result;
+
+/* Called whenever a new best solution is found. */
+typedef void (*lima_progress_fn)(void* user_data, int iteration, double solution_value, double time, int k);
+/* Polled during the search; a non-zero return stops it. */
+typedef int (*lima_cancel_fn)(void* user_data);
+
+void lima_params_init(lima_params* params);
+
+/* coordinates: row-major n_points x n_dimensions, read during the call only.
+ * assignment: caller buffer of n_points ints receiving the cluster of each point. */
+int lima_solve_coordinates(const double* coordinates, int n_points, int n_dimensions,
+		const lima_params* params, lima_progress_fn progress, lima_cancel_fn cancel,
+		void* user_data, int* assignment, lima_result* result);
+
+/* distances: row-major n_points x n_points matrix of squared distances, used in place. */
+int lima_solve_distances(const double* distances, int n_points,
+		const lima_params* params, lima_progress_fn progress, lima_cancel_fn cancel,
+		void* user_data, int* assignment, lima_result* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIMA_VNS_C_H_ */
@@ -13,6 +13,7 @@
 
 #include <sys/times.h>
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 #include <limits.h>
 #include <iostream>
@@ -236,4 +237,92 @@ inline double ChronoReal::GetTime()
   return clockTotal;
 }
 
+//==============================================================
+
+
+// CPU time of the calling thread only, so that helper threads (such as a
+// background validator) do not eat into the time budget of the search.
+// Must be started and read from the same thread.
+class  ChronoThread : public Chrono
+{
+public:
+
+  //constructor and destructor
+   ChronoThread();
+
+  //Resets cumulated time to 0 and indicate that the timer is stopped.
+  void    Reset();
+
+  //start the chrono
+  void    Start();
+
+  //stop the chrono. The time elapsed between the stop and the next start
+  //will not be accumulated.
+  void    Stop();
+
+  //This function returns the current elapsed time.  This function can
+  //be used after the clock is started and after is it stopped.
+  double  GetTime();
+
+private:
+  static double Now();
+};
+
+
+inline ChronoThread::ChronoThread()
+  : Chrono()
+{}
+
+
+inline double ChronoThread::Now()
+{
+  timespec cur;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cur);
+  return cur.tv_sec + cur.tv_nsec/1.0e9;
+}
+
+
+// Resets cumulated time to 0 and indicate that the timer is stopped.
+inline void ChronoThread::Reset()
+{
+  clockTotal = 0.0;
+  fStart = false;
+}
+
+
+// This function indicates that the clock should be started now.     
+inline void ChronoThread::Start()
+{
+  clockStart = Now();
+  fStart = true;
+}
+
+
+// This stops the clock.  This means that the time elapsed between
+// the stop and the next start will not be accumulated.
+inline void ChronoThread::Stop()
+{
+  if (fStart)
+  {
+    clockTotal += Now() - clockStart;
+    fStart = false;
+  }
+  else
+    std::cout <<"start() must be called before using stop()" <<std::endl;
+}
+
+
+// This function returns the current elapsed time.  This function can
+// be used after the clock is started and after is it stopped.
+inline double ChronoThread::GetTime()
+{
+  if(fStart)
+    {
+      double cur = Now();
+      clockTotal += cur - clockStart; 
+      clockStart = cur; 
+    }
+  return clockTotal;
+}
+
 #endif